@@ -0,0 +1,298 @@
+#ifndef AVLTREE_AVLMAP_H
+#define AVLTREE_AVLMAP_H
+
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "AVLTree.h"
+
+/**
+ * Компаратор элементов словаря: сравнивает только ключи,
+ * прозрачен, поэтому поиск по ключу не создаёт пару
+ * @tparam Key - тип ключа
+ * @tparam Value - тип значения
+ * @tparam Compare - компаратор ключей
+ */
+template <class Key, class Value, class Compare>
+struct MapCompare {
+    using is_transparent = void;
+    using Entry = std::pair<const Key, Value>;
+
+    Compare compare;
+
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+        return compare(lhs.first, rhs.first);
+    }
+
+    bool operator()(const Entry& lhs, const Key& rhs) const {
+        return compare(lhs.first, rhs);
+    }
+
+    bool operator()(const Key& lhs, const Entry& rhs) const {
+        return compare(lhs, rhs.first);
+    }
+};
+
+/**
+ * Словарь на AVL дереве
+ * Значение хранится в узле рядом с ключом, поэтому найденный
+ * узел сразу даёт значение без второго поиска
+ * @tparam Key - тип ключей
+ * @tparam Value - тип значений
+ * @tparam Compare - компаратор для упорядочивания ключей
+ * @tparam Allocator - политика выделения памяти под узлы
+ */
+template <class Key, class Value, class Compare = std::less<Key>,
+          class Allocator = NodePool<Node<std::pair<const Key, Value>>>>
+class AVLMap {
+public:
+    using Entry = std::pair<const Key, Value>;
+
+private:
+    using Tree = AVLTree<Entry, MapCompare<Key, Value, Compare>, Allocator>;
+
+public:
+
+    /**
+     * Двунаправленный итератор по элементам в порядке возрастания ключей
+     * (значение можно изменять, ключ - нет)
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entry*;
+        using reference = Entry&;
+
+        Iterator() = default;
+
+        reference operator*() const {
+            // Порядок определяется только ключом, а он константен
+            return const_cast<Entry&>(*it);
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        Iterator& operator++() {
+            ++it;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++it;
+            return result;
+        }
+
+        Iterator& operator--() {
+            --it;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator result = *this;
+            --it;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return it == rhs.it;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return it != rhs.it;
+        }
+
+    private:
+        friend class AVLMap;
+
+        /** Итератор дерева */
+        typename Tree::iterator it;
+
+        explicit Iterator(typename Tree::iterator it) : it(it) {}
+    };
+
+    using iterator = Iterator;
+
+    /**
+     * Конструктор по умолчанию
+     */
+    AVLMap() = default;
+
+    /**
+     * Конструктор с распределителем
+     * @param allocator распределитель памяти под узлы
+     */
+    explicit AVLMap(const Allocator& allocator) : tree(allocator) {}
+
+    /**
+     * Доступ к значению по ключу, при отсутствии ключа
+     * вставляется значение по умолчанию
+     * @param key ключ
+     * @return ссылка на значение
+     */
+    Value& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    Value& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    /**
+     * Доступ к значению существующего ключа
+     * @param key ключ
+     * @return ссылка на значение
+     * @throws std::out_of_range если ключа нет
+     */
+    Value& at(const Key& key) {
+        Node<Entry>* node = tree.existNode(key);
+
+        if (node == nullptr)
+            throw std::out_of_range("AVLMap::at: key not found");
+        return node->key.second;
+    }
+
+    const Value& at(const Key& key) const {
+        return const_cast<AVLMap*>(this)->at(key);
+    }
+
+    /**
+     * Вставка значения, сконструированного на месте из аргументов
+     * (если ключ уже есть, ни ключ, ни значение не создаются)
+     * @param key ключ
+     * @param args аргументы конструктора значения
+     * @return итератор на элемент и признак того, что он был вставлен
+     */
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return emplaceEntry(key, key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return emplaceEntry(key, std::move(key), std::forward<Args>(args)...);
+    }
+
+    /**
+     * Вставка значения или присваивание значению существующего ключа
+     * @param key ключ
+     * @param value значение
+     * @return итератор на элемент и признак того, что он был вставлен
+     */
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) {
+        std::pair<iterator, bool> result = try_emplace(key, std::forward<M>(value));
+
+        if (!result.second)
+            result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value) {
+        std::pair<iterator, bool> result = try_emplace(std::move(key), std::forward<M>(value));
+
+        if (!result.second)
+            result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    /**
+     * Удаление элемента по ключу
+     * @param key ключ
+     * @return был ли элемент удалён
+     */
+    bool remove(const Key& key) {
+        return tree.remove(key);
+    }
+
+    /**
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Key& key) const {
+        return tree.exist(key);
+    }
+
+    /**
+     * Поиск элемента по ключу
+     * @param key ключ
+     * @return итератор на элемент (значение доступно через ->second) или end()
+     */
+    iterator find(const Key& key) const {
+        return iterator(tree.find(key));
+    }
+
+    /**
+     * Первый элемент с ключом, не меньшим заданного
+     */
+    iterator lower_bound(const Key& key) const {
+        return iterator(tree.lower_bound(key));
+    }
+
+    /**
+     * Первый элемент с ключом, большим заданного
+     */
+    iterator upper_bound(const Key& key) const {
+        return iterator(tree.upper_bound(key));
+    }
+
+    /**
+     * Итератор на элемент с наименьшим ключом
+     */
+    iterator begin() const {
+        return iterator(tree.begin());
+    }
+
+    /**
+     * Итератор за элементом с наибольшим ключом
+     */
+    iterator end() const {
+        return iterator(tree.end());
+    }
+
+    /**
+     * Удаление всех элементов
+     */
+    void clear() {
+        tree.clear();
+    }
+
+    /**
+     * Количество элементов
+     * @return размер словаря
+     */
+    size_t getSize() const {
+        return tree.getSize();
+    }
+
+private:
+    /** Дерево элементов, упорядоченных по ключу */
+    Tree tree;
+
+    /**
+     * Вставка элемента, если ключа ещё нет
+     * @param key ключ для поиска
+     * @param keyArg ключ для конструирования элемента
+     * @param args аргументы конструктора значения
+     */
+    template <class K, class... Args>
+    std::pair<iterator, bool> emplaceEntry(const Key& key, K&& keyArg, Args&&... args) {
+        std::pair<Node<Entry>*, bool> inserted = tree.insertNode(key, [&](Node<Entry>* parent) {
+            return tree.createNode(parent, std::piecewise_construct,
+                                   std::forward_as_tuple(std::forward<K>(keyArg)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+
+        return std::make_pair(iterator(tree.result(inserted).first), inserted.second);
+    }
+};
+
+#endif //AVLTREE_AVLMAP_H
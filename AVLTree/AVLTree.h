@@ -3,6 +3,19 @@
 
 #include <iostream>
 #include <fstream>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <string>
+#include "NodePool.h"
+#include "ForkJoinPool.h"
+#include "FrozenAVLTree.h"
+#include "TreeStats.h"
+#include "BalancePolicy.h"
 
 /**
  * Узел дерева
@@ -10,250 +23,2169 @@
  */
 template <class Type>
 struct Node {
-    Type key;             // ключ
-    Node* left;           // указатель на левое поддерево
-    Node* right;          // указатель на правое поддерево
-    long long int height; // высота дерева от данного узла
+    Type key;                       // ключ
+    Node* left;                     // указатель на левое поддерево
+    Node* right;                    // указатель на правое поддерево
+    Node* parent;                   // указатель на родителя
+    long long int height : 63;      // высота дерева от данного узла
+    unsigned long long deleted : 1; // узел помечен удалённым (ленивое удаление)
+    size_t size;                    // количество неудалённых узлов в поддереве
+
+    /**
+     * Создание листа, ключ конструируется на месте из аргументов
+     * @param parent родитель
+     * @param args аргументы конструктора ключа
+     */
+    template <class... Args>
+    explicit Node(Node* parent, Args&&... args)
+        : key(std::forward<Args>(args)...), left(nullptr), right(nullptr), parent(parent), height(1), deleted(false), size(1) {}
+};
+
+/**
+ * Дополнительные данные узла, которые пересчитываются по потомкам вместе
+ * с высотой и размером (в том числе при поворотах). Специализируется
+ * для деревьев с дополнительной информацией в ключе (например, IntervalTree)
+ * @tparam Type - тип хранимого ключа
+ */
+template <class Type>
+struct NodeAugmentation {
+    static constexpr bool enabled = false;
+
+    static void update(Node<Type>*) {}
 };
 
+template <class Key, class Value, class Compare, class Allocator>
+class AVLMap;
+
+template <class Key>
+class IntervalTree;
+
 /**
  * AVLTree
  * @tparam Type - тип хранимых ключей
  * @tparam Compare - компаратор для упорядочивания элементов
+ * @tparam Allocator - политика выделения памяти под узлы
+ * @tparam Stats - политика статистики (NoTreeStats - без статистики, TreeStats - со счётчиками)
+ * @tparam Balance - политика балансировки (AVLBalance или WAVLBalance)
  */
-template <class Type, class Compare = std::less<Type>>
+template <class Type, class Compare = std::less<Type>, class Allocator = NodePool<Node<Type>>,
+          class Stats = NoTreeStats, class Balance = AVLBalance>
 class AVLTree {
 public:
 
+    /**
+     * Двунаправленный итератор по ключам в порядке возрастания
+     * Не выделяет память, переход к соседнему ключу
+     * выполняется по указателям на родителя за амортизированное O(1)
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        Iterator() : node(nullptr), root(nullptr) {}
+
+        reference operator*() const {
+            return node->key;
+        }
+
+        pointer operator->() const {
+            return &node->key;
+        }
+
+        Iterator& operator++() {
+            // Помеченные удалёнными узлы пропускаются
+            do {
+                node = successor(node);
+            } while (node != nullptr && node->deleted);
+
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        Iterator& operator--() {
+            do {
+                // Уменьшение end() дает наибольший ключ
+                if (node == nullptr) {
+                    node = *root;
+                    while (node->right != nullptr)
+                        node = node->right;
+                } else {
+                    node = predecessor(node);
+                }
+            } while (node != nullptr && node->deleted);
+
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return node == rhs.node;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return node != rhs.node;
+        }
+
+    private:
+        friend class AVLTree;
+
+        /** Текущий узел (nullptr для end()) */
+        Node<Type>* node;
+        /** Указатель на корень дерева, нужен для перехода от end() назад */
+        Node<Type>* const* root;
+
+        Iterator(Node<Type>* node, Node<Type>* const* root) : node(node), root(root) {}
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
     /**
      * Конструктор по умолчанию
      */
     AVLTree() {
         head = nullptr;
+        finger = nullptr;
+        size = 0;
+        tombstones = 0;
+        tombstoneLimit = 0;
+    }
+
+    /**
+     * Конструктор с распределителем
+     * (деревья с общим пулом обмениваются узлами без копирования)
+     * @param allocator распределитель памяти под узлы
+     */
+    explicit AVLTree(const Allocator& allocator) : allocator(allocator) {
+        head = nullptr;
+        finger = nullptr;
         size = 0;
+        tombstones = 0;
+        tombstoneLimit = 0;
+    }
+
+    /**
+     * Конструктор из произвольной (неупорядоченной) последовательности ключей
+     * @param first начало последовательности
+     * @param last конец последовательности
+     */
+    template <class InputIterator>
+    AVLTree(InputIterator first, InputIterator last) : AVLTree() {
+        build(first, last);
+    }
+
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
+    /**
+     * Деструктор
+     */
+    ~AVLTree() {
+        clear();
     }
 
     /**
      * Вставка ключа в дерево
      * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
      */
-    void insert(const Type key){
-        insertNode(head, key); // Вызов вспомогательной фунции для рекурсии по узлам
+    std::pair<iterator, bool> insert(const Type& key) {
+        return result(insertNode(key, [&](Node<Type>* parent) {
+            return createNode(parent, key);
+        }));
     }
 
     /**
-     * Удаления ключа из дерева
+     * Вставка ключа в дерево с перемещением
+     * (ключ перемещается, только если его ещё нет в дереве)
      * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
      */
-    void remove(const Type key){
-        deleteNode(head, key); // Вызов вспомогательной фунции для рекурсии по узлам
+    std::pair<iterator, bool> insert(Type&& key) {
+        return result(insertNode(key, [&](Node<Type>* parent) {
+            return createNode(parent, std::move(key));
+        }));
     }
 
     /**
-     * Проверка на существования ключа
+     * Вставка ключа рядом с подсказкой
+     * Если ключ должен стоять непосредственно перед hint (или после него),
+     * вставка выполняется за O(1) сравнений, иначе поиск места начинается
+     * от hint и поднимается лишь настолько, насколько ключ от него далёк
+     * @param hint итератор на ключ рядом с местом вставки
      * @param key ключ
-     * @return результат проверки
+     * @return итератор на ключ
      */
-    bool exist(const Type key) {
-        return existNode(head, key) != nullptr; // Проверка на существование с рекурсией
+    iterator insert(iterator hint, const Type& key) {
+        return result(insertNear(hintNode(hint), key, [&](Node<Type>* parent) {
+            return createNode(parent, key);
+        })).first;
     }
 
-private:
-    /** Указатель на корень дерева */
-    Node<Type>* head;
-    /** Размер дерева */
-    size_t size;
-    /** Компаратор для упорядочивания элемментов */
-    Compare compare;
+    /**
+     * Вставка ключа рядом с подсказкой с перемещением
+     */
+    iterator insert(iterator hint, Type&& key) {
+        return result(insertNear(hintNode(hint), key, [&](Node<Type>* parent) {
+            return createNode(parent, std::move(key));
+        })).first;
+    }
 
     /**
-     * Следующий по возрастанию элемент в дереве
-     * @param node узел
-     * @return
+     * Вставка ключа рядом с местом предыдущей вставки (режим "пальца")
+     * Для почти упорядоченного потока ключей (отметки времени,
+     * порядковые номера) место находится за амортизированное O(1) сравнений
+     * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    std::pair<iterator, bool> insertNearFinger(const Type& key) {
+        return result(insertNear(finger, key, [&](Node<Type>* parent) {
+            return createNode(parent, key);
+        }));
+    }
+
+    /**
+     * Вставка ключа, сконструированного на месте из аргументов
+     * @param args аргументы конструктора ключа
+     * @return итератор на ключ и признак того, что ключ был вставлен
      */
-    Node<Type>* next(Node<Type>* node) {
-        Node<Type>* current = node->right;
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        Node<Type>* node = createNode(nullptr, std::forward<Args>(args)...);
+        std::pair<Node<Type>*, bool> inserted = insertNode(node->key, [node](Node<Type>* parent) {
+            node->parent = parent;
+            return node;
+        });
 
-        while (current->left != nullptr)
-            current = current->left;
+        // Узел не подвешен: ключ уже есть или восстановлен помеченный удалённым узел
+        if (inserted.first != node)
+            destroyNode(node);
 
-        return current;
+        return result(inserted);
     }
 
     /**
-     * Высота дерева от данного узла
-     * @param node узел
-     * @return высота
+     * Удаления ключа из дерева
+     * @param key - ключ
+     * @return был ли ключ удалён
      */
-    long long int height(const Node<Type>* const node) const {
-        return node == nullptr ? 0 : node->height;
+    bool remove(const Type& key) {
+        return tombstoneLimit > 0 ? markDeleted(key) : deleteNode(key);
     }
 
     /**
-     * Характеристика баланса дерева от данного узла (разность высот его поддеревьев)
-     * @param node узел
-     * @return разность высот
+     * Удаление по ключу другого типа (для прозрачного компаратора)
      */
-    long long int getBalance(const Node<Type>* const node) const {
-        return node == nullptr ? 0 : height(node->left) - height(node->right);
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    bool remove(const Key& key) {
+        return tombstoneLimit > 0 ? markDeleted(key) : deleteNode(key);
     }
 
     /**
-     * Малый левый поворот
-     * @param node узел у которого выполняем поворот
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
      */
-    void leftRotate(Node<Type>*& node) {
-        Node<Type>* result = node->right;
-        Node<Type>* tmp = result->left;
-
-        // Изменяем потомков
-        result->left = node;
-        node->right = tmp;
+    bool exist(const Type& key) const {
+        return existNode(key) != nullptr;
+    }
 
-        // Изменяем высоту
-        node->height = std :: max(height(node->left), height(node->right)) + 1;
-        result->height = std :: max(height(result->left), height(result->right)) + 1;
+    /**
+     * Проверка по ключу другого типа без создания временного Type
+     * (для прозрачного компаратора, например std::less<>)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    bool exist(const Key& key) const {
+        return existNode(key) != nullptr;
+    }
 
-        // Присваивание нового корня
-        node = result;
+    /**
+     * Поиск ключа
+     * @param key ключ
+     * @return итератор на ключ или end()
+     */
+    iterator find(const Type& key) const {
+        return iterator(existNode(key), &head);
     }
 
     /**
-     * Малый правый поворот
-     * @param node узел у которого выполняем поворот
+     * Поиск по ключу другого типа (для прозрачного компаратора)
      */
-    void rightRotate(Node<Type>*& node) {
-        Node<Type>* result = node->left;
-        Node<Type>* tmp = result->right;
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator find(const Key& key) const {
+        return iterator(existNode(key), &head);
+    }
 
-        // Изменяем потомков
-        result->right = node;
-        node->left = tmp;
+    /**
+     * Пакетная проверка существования ключей
+     * Несколько независимых поисков выполняются поочерёдно по одному
+     * уровню, и промахи кэша разных поисков перекрываются
+     * @param keys массив ключей
+     * @param count количество ключей
+     * @param out массив результатов
+     */
+    void existBatch(const Type* keys, size_t count, bool* out) const {
+        Node<Type>* found[BatchWidth];
 
-        //  Изменяем высоту
-        node->height = std :: max(height(node->left), height(node->right)) + 1;
-        result->height = std :: max(height(result->left), height(result->right)) + 1;
+        for (size_t first = 0; first < count; first += BatchWidth) {
+            size_t width = std::min(BatchWidth, count - first);
 
-        // Присваивание нового корня
-        node = result;
+            searchBatch(keys + first, width, found);
+            for (size_t i = 0; i < width; ++i)
+                out[first + i] = found[i] != nullptr;
+        }
     }
 
     /**
-     * Рекурсивная вставка ключа
-     * @param node вершина поддерева куда производится вставка
-     * @param key вставляемый ключ
+     * Пакетный поиск ключей
+     * @param keys массив ключей
+     * @param count количество ключей
+     * @param out массив итераторов на найденные ключи (end() если ключа нет)
      */
-    void insertNode(Node<Type>*& node, const Type key) {
-        /* Если не существует узла */
-        if (node == nullptr) {
-            node = new Node<Type>;
-            node->key   = key;
-            node->left   = nullptr;
-            node->right  = nullptr;
-            node->height = 1;
+    void findBatch(const Type* keys, size_t count, iterator* out) const {
+        Node<Type>* found[BatchWidth];
+
+        for (size_t first = 0; first < count; first += BatchWidth) {
+            size_t width = std::min(BatchWidth, count - first);
+
+            searchBatch(keys + first, width, found);
+            for (size_t i = 0; i < width; ++i)
+                out[first + i] = iterator(found[i], &head);
         }
+    }
+
+    /**
+     * Первый ключ, не меньший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator lower_bound(const Type& key) const {
+        return iterator(lowerBoundNode(key), &head);
+    }
 
-        // Спускамся вниз по дереву
-        if (key < node->key)
-            insertNode(node->left, key);
-        else if (key > node->key)
-            insertNode(node->right, key);
+    /**
+     * Первый ключ, не меньший ключа другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator lower_bound(const Key& key) const {
+        return iterator(lowerBoundNode(key), &head);
+    }
 
-        node->height = 1 + std :: max(height(node->left), height(node->right));
+    /**
+     * Первый ключ, больший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator upper_bound(const Type& key) const {
+        return iterator(upperBoundNode(key), &head);
+    }
 
+    /**
+     * Первый ключ, больший ключа другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator upper_bound(const Key& key) const {
+        return iterator(upperBoundNode(key), &head);
+    }
 
-        long long int balance = getBalance(node);
+    /**
+     * Обход ключей из отрезка [lo, hi] в порядке возрастания
+     * без копирования дерева
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @param visitor функция, вызываемая для каждого ключа
+     */
+    template <class Visitor>
+    void range(const Type& lo, const Type& hi, Visitor visitor) const {
+        for (iterator it = lower_bound(lo); it != end() && !compare(hi, *it); ++it)
+            visitor(*it);
+    }
 
-        // Определение нужного поворота
-        if (balance > 1 && key < node->left->key) {
-            rightRotate(node);
-            return;
-        }
-        if (balance < -1 && key > node->right->key) {
-            leftRotate(node);
-            return;
-        }
-        if (balance > 1 && key > node->left->key) {
-            leftRotate(node->left);
-            return rightRotate(node);
-        }
-        if (balance < -1 && key < node->right->key) {
-            rightRotate(node->right);
-            return leftRotate(node);
+    /**
+     * Порядковая статистика: количество ключей, меньших заданного
+     * @param key ключ
+     * @return позиция ключа (или места его вставки) в отсортированном порядке
+     */
+    size_t rank(const Type& key) const {
+        Node<Type>* node = head;
+        size_t result = 0;
+
+        while (node != nullptr) {
+            if (compare(node->key, key)) {
+                result += subtreeSize(node->left) + !node->deleted;
+                node = node->right;
+            } else {
+                node = node->left;
+            }
         }
+
+        return result;
     }
 
     /**
-     * Рекурсивное удаление ключа
-     * @param node вершина поддерева откуда производится удаление
-     * @param key удаляемый ключ
+     * Ключ, стоящий на заданной позиции в отсортированном порядке
+     * @param k позиция (с нуля)
+     * @return итератор на ключ или end(), если k >= количества ключей
      */
-    void deleteNode(Node<Type>*& node, Type key) {
-        if (node == nullptr)
-            return;
+    iterator select(size_t k) const {
+        Node<Type>* node = head;
 
-        if ( key < node->key )
-            deleteNode(node->left, key);
-        else if( key > node->key )
-            deleteNode(node->right, key);
-        else {
-            // Удаление ключа
-            if( (node->left == nullptr) || (node->right == nullptr) ) {
-                Node<Type> *temp = node->left ? node->left : node->right;
-
-                if (temp == nullptr) {
-                    temp = node;
-                    node = nullptr;
-                } else
-                    *node = *temp;
+        while (node != nullptr) {
+            size_t leftSize = subtreeSize(node->left);
+            size_t self = !node->deleted;
 
-                delete temp;
+            if (k < leftSize) {
+                node = node->left;
+            } else if (k < leftSize + self) {
+                break;
             } else {
-                Node<Type>* temp = next(node);
+                k -= leftSize + self;
+                node = node->right;
+            }
+        }
 
-                node->key = temp->key;
+        return iterator(node, &head);
+    }
+
+    /**
+     * Количество ключей из отрезка [lo, hi]
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @return количество ключей
+     */
+    size_t count(const Type& lo, const Type& hi) const {
+        if (compare(hi, lo))
+            return 0;
 
-                deleteNode(node->right, temp->key);
+        // Количество ключей, не больших hi
+        Node<Type>* node = head;
+        size_t notGreater = 0;
+
+        while (node != nullptr) {
+            if (compare(hi, node->key)) {
+                node = node->left;
+            } else {
+                notGreater += subtreeSize(node->left) + !node->deleted;
+                node = node->right;
             }
         }
 
-        if (node == nullptr)
+        return notGreater - rank(lo);
+    }
+
+    /**
+     * Количество ключей в дереве
+     * @return размер дерева
+     */
+    size_t getSize() const {
+        return size;
+    }
+
+    /**
+     * Снимок счётчиков статистики (с политикой NoTreeStats все счётчики,
+     * кроме количества ключей, нулевые)
+     * @return счётчики
+     */
+    TreeCounters getStats() const {
+        TreeCounters result = stats.counters();
+        result.nodes = size;
+        return result;
+    }
+
+    /**
+     * Обнуление счётчиков статистики
+     */
+    void resetStats() {
+        stats.reset();
+    }
+
+    /**
+     * Итератор на наименьший ключ
+     */
+    iterator begin() const {
+        Node<Type>* node = head;
+
+        if (node != nullptr)
+            while (node->left != nullptr)
+                node = node->left;
+
+        return iterator(skipDeleted(node), &head);
+    }
+
+    /**
+     * Итератор за наибольшим ключом
+     */
+    iterator end() const {
+        return iterator(nullptr, &head);
+    }
+
+    /**
+     * Построение идеально сбалансированного дерева
+     * из упорядоченной по возрастанию последовательности за O(n)
+     * Прежнее содержимое дерева удаляется, повторяющиеся ключи пропускаются,
+     * узлы размещаются в памяти подряд в порядке возрастания ключей
+     * @param first начало последовательности
+     * @param last конец последовательности
+     */
+    template <class ForwardIterator>
+    void buildFromSorted(ForwardIterator first, ForwardIterator last) {
+        clear();
+
+        if (first == last)
             return;
 
-        node->height = 1 + std :: max(height(node->left), height(node->right));
+        // Количество различных ключей
+        size_t count = 1;
+        for (ForwardIterator previous = first, it = std::next(first); it != last; previous = it++)
+            if (compare(*previous, *it))
+                count++;
+
+        allocator.reserve(count);
+        head = buildBalanced(first, last, count, nullptr);
+        size = count;
+    }
+
+    /**
+     * Построение дерева из неупорядоченной последовательности
+     * (ключи копируются и сортируются, затем строится дерево за O(n))
+     * @param first начало последовательности
+     * @param last конец последовательности
+     */
+    template <class InputIterator>
+    void build(InputIterator first, InputIterator last) {
+        std::vector<Type> keys(first, last);
+
+        std::sort(keys.begin(), keys.end(), comparator);
+        buildFromSorted(keys.begin(), keys.end());
+    }
+
+    /**
+     * Неизменяемый снимок дерева в порядке Эйтцингера
+     * для частых поисков без переходов по указателям, O(n)
+     * @return снимок
+     */
+    FrozenAVLTree<Type, Compare> freeze() const {
+        return FrozenAVLTree<Type, Compare>(begin(), end(), size);
+    }
+
+    /**
+     * Удаление всех ключей из дерева
+     * (для пула узлов память освобождается за один шаг)
+     */
+    void clear() {
+        // Пул освобождается целиком, только если им не пользуются другие деревья
+        bool bulk = Allocator::bulkRelease && allocator.unique();
+
+        // Обход дерева нужен только если узлы освобождаются по одному
+        // или ключи требуют вызова деструктора
+        if (!bulk || !std::is_trivially_destructible<Type>::value)
+            destroyTree(head);
+
+        if (bulk)
+            allocator.release();
+        head = nullptr;
+        finger = nullptr;
+        size = 0;
+        tombstones = 0;
+    }
 
-        long long int balance = getBalance(node);
+    /**
+     * Режим ленивого удаления: remove только помечает узел удалённым
+     * (без поворотов и освобождения памяти), поиск и обход пропускают
+     * такие узлы, а когда их доля превышает fraction, дерево за O(n)
+     * перестраивается в идеально сбалансированное без них
+     * @param fraction допустимая доля помеченных узлов (0 - режим выключен,
+     * помеченные узлы удаляются сразу)
+     */
+    void setLazyDeletion(double fraction) {
+        tombstoneLimit = fraction;
+        if (tombstoneLimit <= 0)
+            purge();
+    }
 
-        // Определение нужного поворота
-        if (balance > 1 && getBalance(node->left) >= 0) {
-            rightRotate(node);
+    /**
+     * Удаление помеченных узлов с перестройкой дерева за O(n)
+     * (например, в спокойный момент после массового истечения ключей)
+     */
+    void purge() {
+        if (tombstones == 0)
             return;
-        }
-        if (balance > 1 && getBalance(node->left) < 0) {
-            leftRotate(node->left);
-            rightRotate(node);
+
+        Node<Type>* list = nullptr;
+        Node<Type>** tail = &list;
+
+        flatten(head, tail);
+        *tail = nullptr;
+
+        head = buildFromList(list, size, nullptr);
+        finger = nullptr;
+        tombstones = 0;
+    }
+
+    /**
+     * Присоединение дерева, все ключи которого больше ключей
+     * данного дерева, за O(Lg(n))
+     * @param greater присоединяемое дерево (становится пустым)
+     */
+    void join(AVLTree& greater) {
+        static_assert(!Balance::rankBalanced, "join-based operations require AVL balancing");
+
+        if (&greater == this)
             return;
+
+        purge();
+        greater.purge();
+
+        Node<Type>* right = takeNodes(greater);
+
+        if (head == nullptr) {
+            head = right;
+        } else if (right != nullptr) {
+            Node<Type>* last;
+            Node<Type>* rest = splitLast(head, last);
+
+            head = joinNodes(rest, last, right);
         }
-        if (balance < -1 && getBalance(node->right) <= 0) {
-            leftRotate(node);
+
+        finishSetOperation(nullptr);
+    }
+
+    /**
+     * Разделение дерева по ключу за O(Lg(n))
+     * В дереве остаются ключи, меньшие key, остальные переносятся
+     * в greater (его прежнее содержимое удаляется, а пул становится общим)
+     * @param key ключ
+     * @param greater дерево для ключей, не меньших key
+     */
+    void split(const Type& key, AVLTree& greater) {
+        static_assert(!Balance::rankBalanced, "join-based operations require AVL balancing");
+
+        if (&greater == this)
             return;
-        }
-        if (balance < -1 && getBalance(node->right) > 0) {
-            rightRotate(node->right);
-            leftRotate(node);
+
+        purge();
+
+        greater.clear();
+        greater.allocator = allocator;
+
+        SplitResult parts = splitNode(head, key);
+        Node<Type>* right = parts.right;
+
+        if (parts.found != nullptr)
+            right = joinNodes(nullptr, parts.found, right);
+
+        head = parts.left;
+        finishSetOperation(nullptr);
+
+        greater.head = right;
+        greater.finishSetOperation(nullptr);
+    }
+
+    /**
+     * Объединение множеств за O(m*Lg(n/m + 1))
+     * Большие поддеревья обрабатываются параллельно
+     * @param other второе множество (становится пустым)
+     */
+    void unionWith(AVLTree& other) {
+        static_assert(!Balance::rankBalanced, "join-based operations require AVL balancing");
+
+        if (&other == this)
             return;
-        }
+
+        purge();
+        other.purge();
+
+        Node<Type>* second = takeNodes(other);
+        Node<Type>* garbage = nullptr;
+
+        head = unionNodes(head, second, garbage);
+        finishSetOperation(garbage);
     }
 
-    Node<Type>* existNode(Node<Type> *&node, const Type key) {
-        if (node == nullptr)
-            return nullptr;
-        if (node->key == key)
+    /**
+     * Пересечение множеств за O(m*Lg(n/m + 1))
+     * Большие поддеревья обрабатываются параллельно
+     * @param other второе множество (становится пустым)
+     */
+    void intersect(AVLTree& other) {
+        static_assert(!Balance::rankBalanced, "join-based operations require AVL balancing");
+
+        if (&other == this)
+            return;
+
+        purge();
+        other.purge();
+
+        Node<Type>* second = takeNodes(other);
+        Node<Type>* garbage = nullptr;
+
+        head = intersectNodes(head, second, garbage);
+        finishSetOperation(garbage);
+    }
+
+    /**
+     * Разность множеств за O(m*Lg(n/m + 1))
+     * Большие поддеревья обрабатываются параллельно
+     * @param other вычитаемое множество (становится пустым)
+     */
+    void difference(AVLTree& other) {
+        static_assert(!Balance::rankBalanced, "join-based operations require AVL balancing");
+
+        if (&other == this) {
+            clear();
+            return;
+        }
+
+        purge();
+        other.purge();
+
+        Node<Type>* second = takeNodes(other);
+        Node<Type>* garbage = nullptr;
+
+        head = differenceNodes(head, second, garbage);
+        finishSetOperation(garbage);
+    }
+
+private:
+    /** Словарь и дерево интервалов строятся на тех же узлах и балансировке */
+    template <class, class, class, class>
+    friend class AVLMap;
+    template <class>
+    friend class IntervalTree;
+    /** Загрузка из файла строит дерево прямо из массива ключей (TreeFile.h) */
+    template <class Tree>
+    friend bool loadTree(Tree& tree, const std::string& path);
+
+    /** Максимальная высота дерева (AVL дерево из 2^64 узлов ниже 93 уровней) */
+    static constexpr size_t MaxHeight = 96;
+    /** Количество одновременно выполняемых поисков в пакетном поиске */
+    static constexpr size_t BatchWidth = 16;
+    /** Суммарный размер поддеревьев, начиная с которого операции над множествами распараллеливаются */
+    static constexpr size_t ParallelCutoff = 1 << 14;
+
+    /**
+     * Результат разделения поддерева по ключу
+     */
+    struct SplitResult {
+        Node<Type>* left;  // ключи, меньшие заданного
+        Node<Type>* found; // узел с заданным ключом (если был)
+        Node<Type>* right; // ключи, большие заданного
+    };
+
+    /** Указатель на корень дерева */
+    Node<Type>* head;
+    /** Место последней вставки рядом с подсказкой (nullptr - нет) */
+    Node<Type>* finger;
+    /** Размер дерева (без помеченных удалёнными узлов) */
+    size_t size;
+    /** Количество помеченных удалёнными узлов */
+    size_t tombstones;
+    /** Доля помеченных узлов, при превышении которой дерево перестраивается (0 - ленивое удаление выключено) */
+    double tombstoneLimit;
+    /** Компаратор для упорядочивания элемментов */
+    Compare comparator;
+    /** Распределитель памяти под узлы */
+    Allocator allocator;
+    /** Статистика (пустая политика не занимает места в вызовах и удаляется компилятором) */
+    mutable Stats stats;
+
+    /**
+     * Сравнение ключей с учётом в статистике
+     * @return lhs < rhs
+     */
+    template <class Lhs, class Rhs>
+    bool compare(const Lhs& lhs, const Rhs& rhs) const {
+        stats.comparison();
+        return comparator(lhs, rhs);
+    }
+
+    /**
+     * Учёт поворота при балансировке
+     * @param twice был ли поворот большим (двойным)
+     */
+    void countRotation(bool twice) {
+        if (twice)
+            stats.doubleRotation();
+        else
+            stats.singleRotation();
+    }
+
+    /**
+     * Создание листа, ключ конструируется на месте
+     * @param parent родитель
+     * @param args аргументы конструктора ключа
+     * @return новый узел
+     */
+    template <class... Args>
+    Node<Type>* createNode(Node<Type>* parent, Args&&... args) {
+        Node<Type>* node = allocator.allocate();
+        new (node) Node<Type>(parent, std::forward<Args>(args)...);
+        return node;
+    }
+
+    /**
+     * Разрушение узла и возврат его памяти распределителю
+     * @param node узел
+     */
+    void destroyNode(Node<Type>* node) {
+        node->~Node<Type>();
+        allocator.deallocate(node);
+    }
+
+    /**
+     * Разрушение всех узлов поддерева
+     * @param node вершина поддерева
+     */
+    void destroyTree(Node<Type>* node) {
+        if (node == nullptr)
+            return;
+
+        destroyTree(node->left);
+        destroyTree(node->right);
+        destroyNode(node);
+    }
+
+    /**
+     * Рекурсивное построение сбалансированного поддерева из count
+     * различных ключей упорядоченной последовательности
+     * (узлы создаются в порядке возрастания ключей)
+     * @param it текущая позиция в последовательности (сдвигается)
+     * @param last конец последовательности
+     * @param count количество ключей в поддереве
+     * @param parent родитель вершины поддерева
+     * @return вершина поддерева
+     */
+    template <class ForwardIterator>
+    Node<Type>* buildBalanced(ForwardIterator& it, ForwardIterator last, size_t count, Node<Type>* parent) {
+        if (count == 0)
+            return nullptr;
+
+        size_t leftCount = count / 2;
+        Node<Type>* left = buildBalanced(it, last, leftCount, nullptr);
+        Node<Type>* node = createNode(parent, *it);
+
+        // Пропуск повторяющихся ключей
+        ForwardIterator previous = it++;
+        while (it != last && !compare(*previous, *it))
+            ++it;
+
+        node->left = left;
+        if (left != nullptr)
+            left->parent = node;
+        node->right = buildBalanced(it, last, count - leftCount - 1, node);
+        update(node);
+
+        return node;
+    }
+
+    /**
+     * Высота дерева от данного узла
+     * @param node узел
+     * @return высота
+     */
+    long long int height(const Node<Type>* const node) const {
+        return node == nullptr ? 0 : node->height;
+    }
+
+    /**
+     * Количество узлов в поддереве
+     * @param node узел
+     * @return размер поддерева
+     */
+    size_t subtreeSize(const Node<Type>* const node) const {
+        return node == nullptr ? 0 : node->size;
+    }
+
+    /**
+     * Характеристика баланса дерева от данного узла (разность высот его поддеревьев)
+     * @param node узел
+     * @return разность высот
+     */
+    long long int getBalance(const Node<Type>* const node) const {
+        return node == nullptr ? 0 : height(node->left) - height(node->right);
+    }
+
+    /**
+     * Пересчёт высоты и размера поддерева по потомкам
+     * @param node узел
+     */
+    void update(Node<Type>* node) {
+        node->height = std :: max(height(node->left), height(node->right)) + 1;
+        node->size = subtreeSize(node->left) + subtreeSize(node->right) + !node->deleted;
+        NodeAugmentation<Type>::update(node);
+    }
+
+    /**
+     * Пересчёт узла после поворота: AVL высота следует из потомков,
+     * ранги WAVL дерева изменяет сама балансировка
+     * @param node узел
+     */
+    void updateRotated(Node<Type>* node) {
+        if (!Balance::rankBalanced) {
+            update(node);
+            return;
+        }
+
+        node->size = subtreeSize(node->left) + subtreeSize(node->right) + !node->deleted;
+        NodeAugmentation<Type>::update(node);
+    }
+
+    /**
+     * Ссылка на узел из родителя (или на корень)
+     * @param node узел
+     * @return ссылка
+     */
+    Node<Type>*& parentLink(Node<Type>* node) {
+        Node<Type>* parent = node->parent;
+        return parent == nullptr ? head : parent->left == node ? parent->left : parent->right;
+    }
+
+    /**
+     * Пересчёт дополнительных данных узлов от заданного до корня
+     * (подъём при вставке и удалении может прекратиться раньше)
+     * @param node нижний изменившийся узел
+     */
+    void augmentPath(Node<Type>* node) {
+        if (!NodeAugmentation<Type>::enabled)
+            return;
+
+        for (; node != nullptr; node = node->parent)
+            NodeAugmentation<Type>::update(node);
+    }
+
+    /**
+     * Малый левый поворот
+     * @param node узел у которого выполняем поворот
+     */
+    void leftRotate(Node<Type>*& node) {
+        Node<Type>* result = node->right;
+        Node<Type>* tmp = result->left;
+
+        // Изменяем потомков
+        result->left = node;
+        node->right = tmp;
+
+        // Изменяем родителей
+        result->parent = node->parent;
+        node->parent = result;
+        if (tmp != nullptr)
+            tmp->parent = node;
+
+        // Изменяем высоту и размеры поддеревьев
+        updateRotated(node);
+        updateRotated(result);
+
+        // Присваивание нового корня
+        node = result;
+    }
+
+    /**
+     * Малый правый поворот
+     * @param node узел у которого выполняем поворот
+     */
+    void rightRotate(Node<Type>*& node) {
+        Node<Type>* result = node->left;
+        Node<Type>* tmp = result->right;
+
+        // Изменяем потомков
+        result->right = node;
+        node->left = tmp;
+
+        // Изменяем родителей
+        result->parent = node->parent;
+        node->parent = result;
+        if (tmp != nullptr)
+            tmp->parent = node;
+
+        //  Изменяем высоту и размеры поддеревьев
+        updateRotated(node);
+        updateRotated(result);
+
+        // Присваивание нового корня
+        node = result;
+    }
+
+    /**
+     * Итеративная вставка ключа
+     * Путь от корня запоминается в явном стеке, после вставки
+     * подъём по нему прекращается, как только высота поддерева
+     * перестала меняться (при вставке это не более одного поворота)
+     * @param key вставляемый ключ
+     * @param create создание узла по родителю (вызывается, только если ключа нет)
+     * @return узел с ключом и признак того, что он был создан
+     */
+    template <class Key, class Factory>
+    std::pair<Node<Type>*, bool> insertNode(const Key& key, Factory create) {
+        Node<Type>** path[MaxHeight]; // Ссылки на узлы пути от корня
+        size_t depth = 0;
+        Node<Type>** link = &head;
+        Node<Type>* parent = nullptr;
+
+        stats.operation(1);
+
+        // Спускаемся вниз по дереву
+        while (*link != nullptr) {
+            Node<Type>* node = *link;
+
+            bool less = compare(key, node->key);
+
+            if (!less && !compare(node->key, key)) {
+                stats.depth(depth + 1);
+                return existing(node); // Ключ уже есть в дереве
+            }
+
+            path[depth++] = link;
+            parent = node;
+            link = less ? &node->left : &node->right;
+        }
+
+        stats.depth(depth + 1);
+
+        Node<Type>* created = create(parent);
+
+        *link = created;
+        size++;
+
+        // Размеры поддеревьев на пути меняются до самого корня
+        for (size_t i = 0; i < depth; ++i)
+            (*path[i])->size++;
+
+        if (Balance::rankBalanced)
+            retraceRankInsert(created);
+        else
+            retraceInsert(path, depth);
+        augmentPath(created);
+        return std::make_pair(created, true);
+    }
+
+    /**
+     * Восстановление баланса после вставки
+     * @param path ссылки на узлы пути от корня
+     * @param depth длина пути
+     */
+    void retraceInsert(Node<Type>** path[], size_t depth) {
+        while (depth > 0) {
+            Node<Type>*& node = *path[--depth];
+            long long int previous = node->height;
+
+            node->height = 1 + std :: max(height(node->left), height(node->right));
+
+            long long int balance = getBalance(node);
+
+            // Определение нужного поворота, после поворота
+            // высота поддерева возвращается к прежней
+            if (balance > 1) {
+                bool twice = getBalance(node->left) < 0;
+
+                if (twice)
+                    leftRotate(node->left);
+                rightRotate(node);
+                countRotation(twice);
+                return;
+            }
+            if (balance < -1) {
+                bool twice = getBalance(node->right) > 0;
+
+                if (twice)
+                    rightRotate(node->right);
+                leftRotate(node);
+                countRotation(twice);
+                return;
+            }
+
+            // Высота не изменилась - выше баланс не нарушен
+            if (node->height == previous)
+                return;
+        }
+    }
+
+    /**
+     * Следующий по возрастанию узел
+     * @param node узел
+     * @return узел или nullptr
+     */
+    static Node<Type>* successor(Node<Type>* node) {
+        if (node->right != nullptr) {
+            // Самый левый узел правого поддерева
+            node = node->right;
+            while (node->left != nullptr)
+                node = node->left;
             return node;
-        if (node->key > key)
-            return existNode(node->left, key);
+        }
+
+        // Поднимаемся, пока приходим из правого поддерева
+        Node<Type>* previous = node;
+        node = node->parent;
+        while (node != nullptr && node->right == previous) {
+            previous = node;
+            node = node->parent;
+        }
+        return node;
+    }
+
+    /**
+     * Предыдущий по возрастанию узел
+     * @param node узел
+     * @return узел или nullptr
+     */
+    static Node<Type>* predecessor(Node<Type>* node) {
+        if (node->left != nullptr) {
+            // Самый правый узел левого поддерева
+            node = node->left;
+            while (node->right != nullptr)
+                node = node->right;
+            return node;
+        }
+
+        // Поднимаемся, пока приходим из левого поддерева
+        Node<Type>* previous = node;
+        node = node->parent;
+        while (node != nullptr && node->left == previous) {
+            previous = node;
+            node = node->parent;
+        }
+        return node;
+    }
+
+    /**
+     * Узел, от которого начинается вставка по подсказке
+     * (для end() - наибольший узел)
+     * @param hint подсказка
+     * @return узел или nullptr для пустого дерева
+     */
+    Node<Type>* hintNode(iterator hint) const {
+        if (hint.node != nullptr || head == nullptr)
+            return hint.node;
+
+        return (--hint).node;
+    }
+
+    /**
+     * Вставка ключа с поиском места от заданного узла (finger search)
+     * Сначала проверяется промежуток между узлом и его соседом в сторону
+     * ключа, затем подъём от соседа до поддерева, в диапазон которого
+     * попадает ключ, и спуск внутри него
+     * @param near узел рядом с местом вставки (nullptr - поиск от корня)
+     * @param key вставляемый ключ
+     * @param create создание узла по родителю (вызывается, только если ключа нет)
+     * @return узел с ключом и признак того, что он был создан
+     */
+    template <class Key, class Factory>
+    std::pair<Node<Type>*, bool> insertNear(Node<Type>* near, const Key& key, Factory create) {
+        std::pair<Node<Type>*, bool> inserted;
+
+        if (near == nullptr) {
+            inserted = insertNode(key, create);
+        } else {
+            stats.operation(1);
+
+            bool less = compare(key, near->key);
+
+            if (!less && !compare(near->key, key)) {
+                inserted = existing(near);
+            } else {
+                // Сосед узла в сторону ключа (в том числе помеченный удалённым)
+                Node<Type>* neighbor = less ? predecessor(near) : successor(near);
+
+                if (neighbor == nullptr || (less ? compare(neighbor->key, key) : compare(key, neighbor->key))) {
+                    // Ключ попадает между узлом и соседом: у одного из них свободна нужная ссылка
+                    Node<Type>* parent = near;
+                    Node<Type>** link = less ? &near->left : &near->right;
+
+                    if (*link != nullptr) {
+                        parent = neighbor;
+                        link = less ? &neighbor->right : &neighbor->left;
+                    }
+                    inserted = attachLeaf(parent, link, create);
+                } else if (less ? !compare(key, neighbor->key) : !compare(neighbor->key, key)) {
+                    inserted = existing(neighbor);
+                } else {
+                    // Подъём, пока граница поддерева со стороны ключа не окажется за ключом
+                    Node<Type>* node = neighbor;
+
+                    while (node->parent != nullptr) {
+                        Node<Type>* parent = node->parent;
+
+                        if ((parent->left == node) != less &&
+                            (less ? compare(parent->key, key) : compare(key, parent->key)))
+                            break;
+                        node = parent;
+                    }
+
+                    if (node->parent != nullptr) {
+                        inserted = descendFrom(node, key, create);
+                    } else {
+                        // Дошли до корня: ключ, вероятно, новый крайний (частый случай для
+                        // почти упорядоченного потока), это проверяется одним сравнением
+                        Node<Type>* edge = node;
+                        while ((less ? edge->left : edge->right) != nullptr)
+                            edge = less ? edge->left : edge->right;
+
+                        if (less ? compare(key, edge->key) : compare(edge->key, key)) {
+                            inserted = attachLeaf(edge, less ? &edge->left : &edge->right, create);
+                        } else {
+                            // Иначе ключ близок к краю: подъём от крайнего узла по краевому
+                            // пути до первого узла, за который ключ уже не выходит
+                            while (edge->parent != nullptr &&
+                                   (less ? compare(edge->parent->key, key) : compare(key, edge->parent->key)))
+                                edge = edge->parent;
+                            inserted = descendFrom(edge->parent != nullptr ? edge->parent : edge, key, create);
+                        }
+                    }
+                }
+            }
+        }
+
+        finger = inserted.first;
+        return inserted;
+    }
+
+    /**
+     * Спуск от узла к месту вставки ключа
+     * (ключ лежит в диапазоне поддерева узла)
+     * @param node вершина поддерева
+     * @param key вставляемый ключ
+     * @param create создание узла по родителю
+     * @return узел с ключом и признак того, что он был создан
+     */
+    template <class Key, class Factory>
+    std::pair<Node<Type>*, bool> descendFrom(Node<Type>* node, const Key& key, Factory create) {
+        Node<Type>* parent;
+        Node<Type>** link;
+
+        do {
+            bool less = compare(key, node->key);
+
+            if (!less && !compare(node->key, key))
+                return existing(node);
+
+            parent = node;
+            link = less ? &node->left : &node->right;
+            node = *link;
+        } while (node != nullptr);
+
+        return attachLeaf(parent, link, create);
+    }
+
+    /**
+     * Подвешивание нового листа на свободную ссылку
+     * @param parent родитель
+     * @param link свободная ссылка родителя
+     * @param create создание узла по родителю
+     * @return созданный узел и признак вставки
+     */
+    template <class Factory>
+    std::pair<Node<Type>*, bool> attachLeaf(Node<Type>* parent, Node<Type>** link, Factory create) {
+        Node<Type>* created = create(parent);
+
+        *link = created;
+        size++;
+        if (Balance::rankBalanced) {
+            for (Node<Type>* node = parent; node != nullptr; node = node->parent)
+                node->size++;
+            retraceRankInsert(created);
+        } else {
+            retraceInsertFrom(parent);
+        }
+        augmentPath(created);
+        return std::make_pair(created, true);
+    }
+
+    /**
+     * Восстановление баланса после вставки с подъёмом по указателям на родителя
+     * Повороты прекращаются так же, как в retraceInsert, но размеры
+     * поддеревьев увеличиваются до самого корня
+     * @param node родитель вставленного листа
+     */
+    void retraceInsertFrom(Node<Type>* node) {
+        bool balanced = false;
+
+        while (node != nullptr) {
+            Node<Type>* parent = node->parent;
+
+            node->size++;
+
+            if (!balanced) {
+                Node<Type>*& link = parent == nullptr ? head : parent->left == node ? parent->left : parent->right;
+                long long int previous = node->height;
+
+                node->height = 1 + std :: max(height(node->left), height(node->right));
+
+                long long int balance = getBalance(node);
+
+                if (balance > 1) {
+                    bool twice = getBalance(node->left) < 0;
+
+                    if (twice)
+                        leftRotate(node->left);
+                    rightRotate(link);
+                    countRotation(twice);
+                    balanced = true;
+                } else if (balance < -1) {
+                    bool twice = getBalance(node->right) > 0;
+
+                    if (twice)
+                        rightRotate(node->right);
+                    leftRotate(link);
+                    countRotation(twice);
+                    balanced = true;
+                } else if (node->height == previous) {
+                    balanced = true;
+                }
+            }
+
+            node = parent;
+        }
+    }
+
+    /**
+     * Итеративное удаление ключа
+     * Узел с двумя потомками заменяется следующим по возрастанию
+     * узлом (перевешиванием, а не копированием ключа)
+     * @param key удаляемый ключ
+     * @return был ли ключ удалён
+     */
+    template <class Key>
+    bool deleteNode(const Key& key) {
+        Node<Type>** path[MaxHeight]; // Ссылки на узлы пути от корня
+        size_t depth = 0;
+        Node<Type>** link = &head;
+
+        stats.operation(1);
+
+        // Поиск удаляемого узла
+        while (*link != nullptr) {
+            Node<Type>* node = *link;
+
+            bool less = compare(key, node->key);
+
+            if (!less && !compare(node->key, key))
+                break;
+
+            path[depth++] = link;
+            link = less ? &node->left : &node->right;
+        }
+
+        Node<Type>* node = *link;
+
+        stats.depth(node == nullptr ? depth : depth + 1);
+        if (node == nullptr)
+            return false;
+
+        // Нижний узел, у которого изменилось поддерево,
+        // и поддерево, занявшее место вырезанного узла
+        Node<Type>* lowest = node->parent;
+        Node<Type>* replacement;
+
+        if (node->left == nullptr || node->right == nullptr) {
+            Node<Type>* child = node->left ? node->left : node->right;
+
+            if (child != nullptr)
+                child->parent = node->parent;
+            *link = child;
+            replacement = child;
+        } else {
+            size_t nodeDepth = depth;
+            Node<Type>** successorLink = &node->right;
+
+            // Спуск к следующему по возрастанию узлу
+            path[depth++] = link;
+            while ((*successorLink)->left != nullptr) {
+                path[depth++] = successorLink;
+                successorLink = &(*successorLink)->left;
+            }
+
+            Node<Type>* successor = *successorLink;
+
+            lowest = successor->parent == node ? successor : successor->parent;
+            replacement = successor->right;
+
+            // Вырезаем преемника и ставим его на место удаляемого узла
+            *successorLink = successor->right;
+            if (successor->right != nullptr)
+                successor->right->parent = successor->parent;
+
+            successor->left = node->left;
+            successor->right = node->right;
+            successor->parent = node->parent;
+            successor->height = node->height;
+            successor->size = node->size;
+            successor->left->parent = successor;
+            if (successor->right != nullptr)
+                successor->right->parent = successor;
+            *link = successor;
+
+            // Ссылка на правое поддерево теперь принадлежит преемнику
+            if (depth > nodeDepth + 1)
+                path[nodeDepth + 1] = &successor->right;
+        }
+
+        if (node == finger)
+            finger = nullptr;
+        destroyNode(node);
+        size--;
+
+        // Размеры поддеревьев на пути меняются до самого корня
+        for (size_t i = 0; i < depth; ++i)
+            (*path[i])->size--;
+
+        if (Balance::rankBalanced)
+            retraceRankDelete(lowest, replacement);
+        else
+            retraceDelete(path, depth);
+        augmentPath(lowest);
+        return true;
+    }
+
+    /**
+     * Восстановление баланса после удаления
+     * Подъём прекращается, когда высота поддерева не изменилась
+     * @param path ссылки на узлы пути от корня
+     * @param depth длина пути
+     */
+    void retraceDelete(Node<Type>** path[], size_t depth) {
+        while (depth > 0) {
+            Node<Type>*& node = *path[--depth];
+            long long int previous = node->height;
+
+            node->height = 1 + std :: max(height(node->left), height(node->right));
+
+            long long int balance = getBalance(node);
+
+            // Определение нужного поворота
+            if (balance > 1) {
+                bool twice = getBalance(node->left) < 0;
+
+                if (twice)
+                    leftRotate(node->left);
+                rightRotate(node);
+                countRotation(twice);
+            }
+            else if (balance < -1) {
+                bool twice = getBalance(node->right) > 0;
+
+                if (twice)
+                    rightRotate(node->right);
+                leftRotate(node);
+                countRotation(twice);
+            }
+
+            // Высота не изменилась - выше баланс не нарушен
+            if (node->height == previous)
+                return;
+        }
+    }
+
+    /**
+     * Восстановление рангов WAVL дерева после вставки листа
+     * Пока узел - 0-потомок (ранг равен рангу родителя), а родитель -
+     * 0,1 узел, ранг родителя повышается; 0,2 родитель исправляется
+     * одним малым или большим поворотом
+     * @param node вставленный лист
+     */
+    void retraceRankInsert(Node<Type>* node) {
+        Node<Type>* parent = node->parent;
+
+        while (parent != nullptr && parent->height == node->height) {
+            bool left = parent->left == node;
+            Node<Type>* sibling = left ? parent->right : parent->left;
+
+            if (parent->height - height(sibling) == 1) {
+                parent->height++;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+
+            Node<Type>* inner = left ? node->right : node->left;
+            Node<Type>*& link = parentLink(parent);
+            bool twice = node->height - height(inner) == 1;
+
+            if (twice) {
+                if (left)
+                    leftRotate(parent->left);
+                else
+                    rightRotate(parent->right);
+                inner->height++;
+                node->height--;
+            }
+            if (left)
+                rightRotate(link);
+            else
+                leftRotate(link);
+            parent->height--;
+            countRotation(twice);
+            return;
+        }
+    }
+
+    /**
+     * Восстановление рангов WAVL дерева после удаления
+     * 2,2 лист и 3-потомок исправляются понижением рангов вверх по дереву,
+     * поворот (малый или большой) выполняется не более одного раза
+     * и завершает балансировку
+     * @param parent родитель вырезанного узла (после перевешивания)
+     * @param child поддерево, занявшее место вырезанного узла (может быть nullptr)
+     */
+    void retraceRankDelete(Node<Type>* parent, Node<Type>* child) {
+        if (parent == nullptr)
+            return;
+
+        // Лист с рангом 2 (оба потомка - 2-потомки) запрещён
+        if (parent->left == nullptr && parent->right == nullptr && parent->height == 2) {
+            parent->height = 1;
+            child = parent;
+            parent = child->parent;
+        }
+
+        while (parent != nullptr && parent->height - height(child) == 3) {
+            bool left = parent->left == child;
+            Node<Type>* sibling = left ? parent->right : parent->left;
+
+            if (parent->height - sibling->height == 2) {
+                parent->height--;
+            } else if (sibling->height - height(sibling->left) == 2 &&
+                       sibling->height - height(sibling->right) == 2) {
+                parent->height--;
+                sibling->height--;
+            } else {
+                Node<Type>* outer = left ? sibling->right : sibling->left;
+                Node<Type>* inner = left ? sibling->left : sibling->right;
+                Node<Type>*& link = parentLink(parent);
+                bool twice = sibling->height - height(outer) == 2;
+
+                if (twice) {
+                    if (left)
+                        rightRotate(parent->right);
+                    else
+                        leftRotate(parent->left);
+                }
+                if (left)
+                    leftRotate(link);
+                else
+                    rightRotate(link);
+
+                if (twice) {
+                    inner->height += 2;
+                    sibling->height--;
+                    parent->height -= 2;
+                } else {
+                    sibling->height++;
+                    parent->height--;
+                    if (parent->left == nullptr && parent->right == nullptr)
+                        parent->height--;
+                }
+                countRotation(twice);
+                return;
+            }
+
+            child = parent;
+            parent = child->parent;
+        }
+    }
+
+    /**
+     * Подвешивание двух поддеревьев к узлу
+     * @param left левое поддерево
+     * @param node узел
+     * @param right правое поддерево
+     * @return узел
+     */
+    Node<Type>* attach(Node<Type>* left, Node<Type>* node, Node<Type>* right) {
+        node->left = left;
+        node->right = right;
+        if (left != nullptr)
+            left->parent = node;
+        if (right != nullptr)
+            right->parent = node;
+        update(node);
+        return node;
+    }
+
+    /**
+     * Соединение поддеревьев через узел за O(|h(left) - h(right)| + 1)
+     * (все ключи left меньше ключа node, все ключи right больше)
+     * @param left левое поддерево
+     * @param node средний узел
+     * @param right правое поддерево
+     * @return вершина сбалансированного поддерева
+     */
+    Node<Type>* joinNodes(Node<Type>* left, Node<Type>* node, Node<Type>* right) {
+        Node<Type>* result;
+
+        if (height(left) > height(right) + 1)
+            result = joinRight(left, node, right);
+        else if (height(right) > height(left) + 1)
+            result = joinLeft(left, node, right);
         else
-            return existNode(node->right, key);
+            result = attach(left, node, right);
+
+        result->parent = nullptr;
+        return result;
+    }
+
+    /**
+     * Соединение, когда левое поддерево выше:
+     * спуск по правому краю left до поддерева подходящей высоты
+     */
+    Node<Type>* joinRight(Node<Type>* left, Node<Type>* node, Node<Type>* right) {
+        Node<Type>* outer = left->left;
+        Node<Type>* inner = left->right;
+
+        if (height(inner) <= height(right) + 1) {
+            Node<Type>* subtree = attach(inner, node, right);
+
+            if (height(subtree) <= height(outer) + 1)
+                return attach(outer, left, subtree);
+
+            rightRotate(subtree);
+            Node<Type>* result = attach(outer, left, subtree);
+            leftRotate(result);
+            return result;
+        }
+
+        Node<Type>* subtree = joinRight(inner, node, right);
+        Node<Type>* result = attach(outer, left, subtree);
+
+        if (height(subtree) > height(outer) + 1)
+            leftRotate(result);
+        return result;
+    }
+
+    /**
+     * Соединение, когда правое поддерево выше:
+     * спуск по левому краю right до поддерева подходящей высоты
+     */
+    Node<Type>* joinLeft(Node<Type>* left, Node<Type>* node, Node<Type>* right) {
+        Node<Type>* outer = right->right;
+        Node<Type>* inner = right->left;
+
+        if (height(inner) <= height(left) + 1) {
+            Node<Type>* subtree = attach(left, node, inner);
+
+            if (height(subtree) <= height(outer) + 1)
+                return attach(subtree, right, outer);
+
+            leftRotate(subtree);
+            Node<Type>* result = attach(subtree, right, outer);
+            rightRotate(result);
+            return result;
+        }
+
+        Node<Type>* subtree = joinLeft(left, node, inner);
+        Node<Type>* result = attach(subtree, right, outer);
+
+        if (height(subtree) > height(outer) + 1)
+            rightRotate(result);
+        return result;
+    }
+
+    /**
+     * Разделение поддерева по ключу за O(Lg(n))
+     * @param node вершина поддерева
+     * @param key ключ
+     * @return поддеревья меньших и больших ключей и узел с самим ключом
+     */
+    SplitResult splitNode(Node<Type>* node, const Type& key) {
+        if (node == nullptr)
+            return {nullptr, nullptr, nullptr};
+
+        Node<Type>* left = node->left;
+        Node<Type>* right = node->right;
+
+        // Сравнения не учитываются в статистике: разделение
+        // выполняется и из параллельных задач
+        if (comparator(key, node->key)) {
+            SplitResult result = splitNode(left, key);
+            result.right = joinNodes(result.right, node, right);
+            return result;
+        }
+        if (comparator(node->key, key)) {
+            SplitResult result = splitNode(right, key);
+            result.left = joinNodes(left, node, result.left);
+            return result;
+        }
+
+        return {left, node, right};
+    }
+
+    /**
+     * Отделение наибольшего узла от поддерева
+     * @param node вершина поддерева (не пустого)
+     * @param last отделённый узел
+     * @return оставшееся поддерево
+     */
+    Node<Type>* splitLast(Node<Type>* node, Node<Type>*& last) {
+        if (node->right == nullptr) {
+            last = node;
+            return node->left;
+        }
+
+        Node<Type>* rest = splitLast(node->right, last);
+        return joinNodes(node->left, node, rest);
+    }
+
+    /**
+     * Соединение поддеревьев без среднего узла
+     * (все ключи left меньше всех ключей right)
+     */
+    Node<Type>* joinTwo(Node<Type>* left, Node<Type>* right) {
+        if (left == nullptr)
+            return right;
+
+        Node<Type>* last;
+        Node<Type>* rest = splitLast(left, last);
+        return joinNodes(rest, last, right);
+    }
+
+    /**
+     * Добавление поддерева в список удаляемых
+     * (список связан через указатели на родителя)
+     * @param node вершина поддерева
+     * @param garbage список удаляемых поддеревьев
+     */
+    static void discard(Node<Type>* node, Node<Type>*& garbage) {
+        node->parent = garbage;
+        garbage = node;
+    }
+
+    /**
+     * Добавление одного узла в список удаляемых
+     */
+    static void discardNode(Node<Type>* node, Node<Type>*& garbage) {
+        node->left = nullptr;
+        node->right = nullptr;
+        discard(node, garbage);
+    }
+
+    /**
+     * Присоединение списка удаляемых поддеревьев к другому
+     */
+    static void appendGarbage(Node<Type>* list, Node<Type>*& garbage) {
+        while (list != nullptr) {
+            Node<Type>* next = list->parent;
+            discard(list, garbage);
+            list = next;
+        }
+    }
+
+    /**
+     * Вызов двух ветвей рекурсии, параллельно для больших поддеревьев
+     * @param work суммарный размер обрабатываемых поддеревьев
+     */
+    template <class Left, class Right>
+    static void forkJoin(size_t work, Left&& left, Right&& right) {
+        if (work < ParallelCutoff) {
+            left();
+            right();
+        } else {
+            ForkJoinPool::common().invoke(left, right);
+        }
+    }
+
+    /**
+     * Рекурсивное объединение поддеревьев
+     * (узлы-дубликаты второго поддерева попадают в garbage)
+     */
+    Node<Type>* unionNodes(Node<Type>* first, Node<Type>* second, Node<Type>*& garbage) {
+        if (first == nullptr)
+            return second;
+        if (second == nullptr)
+            return first;
+
+        size_t work = first->size + second->size;
+        Node<Type>* left = first->left;
+        Node<Type>* right = first->right;
+        SplitResult parts = splitNode(second, first->key);
+
+        if (parts.found != nullptr)
+            discardNode(parts.found, garbage);
+
+        Node<Type>* rightGarbage = nullptr;
+        forkJoin(work,
+                 [&] { left = unionNodes(left, parts.left, garbage); },
+                 [&] { right = unionNodes(right, parts.right, rightGarbage); });
+        appendGarbage(rightGarbage, garbage);
+
+        return joinNodes(left, first, right);
+    }
+
+    /**
+     * Рекурсивное пересечение поддеревьев
+     * (узлы, не попавшие в результат, попадают в garbage)
+     */
+    Node<Type>* intersectNodes(Node<Type>* first, Node<Type>* second, Node<Type>*& garbage) {
+        if (first == nullptr || second == nullptr) {
+            if (first != nullptr)
+                discard(first, garbage);
+            if (second != nullptr)
+                discard(second, garbage);
+            return nullptr;
+        }
+
+        size_t work = first->size + second->size;
+        Node<Type>* left = first->left;
+        Node<Type>* right = first->right;
+        SplitResult parts = splitNode(second, first->key);
+
+        Node<Type>* rightGarbage = nullptr;
+        forkJoin(work,
+                 [&] { left = intersectNodes(left, parts.left, garbage); },
+                 [&] { right = intersectNodes(right, parts.right, rightGarbage); });
+        appendGarbage(rightGarbage, garbage);
+
+        if (parts.found != nullptr) {
+            discardNode(parts.found, garbage);
+            return joinNodes(left, first, right);
+        }
+
+        discardNode(first, garbage);
+        return joinTwo(left, right);
+    }
+
+    /**
+     * Рекурсивная разность поддеревьев
+     * (узлы, не попавшие в результат, попадают в garbage)
+     */
+    Node<Type>* differenceNodes(Node<Type>* first, Node<Type>* second, Node<Type>*& garbage) {
+        if (first == nullptr || second == nullptr) {
+            if (second != nullptr)
+                discard(second, garbage);
+            return first;
+        }
+
+        size_t work = first->size + second->size;
+        Node<Type>* left = second->left;
+        Node<Type>* right = second->right;
+        SplitResult parts = splitNode(first, second->key);
+
+        discardNode(second, garbage);
+        if (parts.found != nullptr)
+            discardNode(parts.found, garbage);
+
+        Node<Type>* rightGarbage = nullptr;
+        forkJoin(work,
+                 [&] { left = differenceNodes(parts.left, left, garbage); },
+                 [&] { right = differenceNodes(parts.right, right, rightGarbage); });
+        appendGarbage(rightGarbage, garbage);
+
+        return joinTwo(left, right);
+    }
+
+    /**
+     * Забрать узлы другого дерева (оно становится пустым)
+     * При разных пулах ключи копируются в пул данного дерева
+     * @param other дерево
+     * @return вершина поддерева с узлами в пуле данного дерева
+     */
+    Node<Type>* takeNodes(AVLTree& other) {
+        Node<Type>* result;
+
+        if (allocator == other.allocator) {
+            result = other.head;
+        } else {
+            AVLTree copy(allocator);
+
+            copy.buildFromSorted(other.begin(), other.end());
+            other.clear();
+            result = copy.head;
+            copy.head = nullptr;
+        }
+
+        other.head = nullptr;
+        other.finger = nullptr;
+        other.size = 0;
+        return result;
+    }
+
+    /**
+     * Завершение операции над множествами: корень, размер
+     * и освобождение узлов, не попавших в результат
+     * @param garbage список удаляемых поддеревьев
+     */
+    void finishSetOperation(Node<Type>* garbage) {
+        finger = nullptr;
+        if (head != nullptr)
+            head->parent = nullptr;
+        size = subtreeSize(head);
+
+        while (garbage != nullptr) {
+            Node<Type>* next = garbage->parent;
+            destroyTree(garbage);
+            garbage = next;
+        }
+    }
+
+    /**
+     * Подгрузка узла в кэш
+     * @param node узел
+     */
+    static void prefetch(const Node<Type>* node) {
+#if defined(__GNUC__)
+        __builtin_prefetch(node);
+#endif
+    }
+
+    /**
+     * Поиск группы ключей с чередованием: на каждом шаге каждый
+     * незавершённый поиск спускается на один уровень и заранее
+     * запрашивает в кэш следующий узел
+     * @param keys ключи (не более BatchWidth)
+     * @param width количество ключей
+     * @param found найденные узлы (nullptr если ключа нет)
+     */
+    void searchBatch(const Type* keys, size_t width, Node<Type>** found) const {
+        Node<Type>* current[BatchWidth];
+        size_t active = 0;
+        size_t level = 0;
+
+        stats.operation(width);
+
+        for (size_t i = 0; i < width; ++i) {
+            current[i] = head;
+            found[i] = nullptr;
+        }
+        if (head != nullptr)
+            active = width;
+
+        while (active > 0) {
+            active = 0;
+            level++;
+
+            for (size_t i = 0; i < width; ++i) {
+                Node<Type>* node = current[i];
+
+                if (node == nullptr)
+                    continue;
+
+                if (compare(keys[i], node->key)) {
+                    node = node->left;
+                } else if (compare(node->key, keys[i])) {
+                    node = node->right;
+                } else {
+                    found[i] = node->deleted ? nullptr : node;
+                    node = nullptr;
+                }
+
+                current[i] = node;
+                if (node != nullptr) {
+                    prefetch(node);
+                    active++;
+                } else {
+                    stats.depth(level);
+                }
+            }
+        }
+    }
+
+    /**
+     * Итеративный поиск узла с заданным ключом
+     * @param key ключ
+     * @return узел или nullptr
+     */
+    template <class Key>
+    Node<Type>* existNode(const Key& key) const {
+        Node<Type>* node = head;
+        size_t depth = 0;
+
+        stats.operation(1);
+
+        while (node != nullptr) {
+            depth++;
+            if (compare(key, node->key))
+                node = node->left;
+            else if (compare(node->key, key))
+                node = node->right;
+            else
+                break;
+        }
+
+        stats.depth(depth);
+
+        return node != nullptr && node->deleted ? nullptr : node;
+    }
+
+    /**
+     * Узел с первым ключом, не меньшим заданного
+     * @param key ключ
+     * @return узел или nullptr
+     */
+    template <class Key>
+    Node<Type>* lowerBoundNode(const Key& key) const {
+        Node<Type>* node = head;
+        Node<Type>* result = nullptr;
+        size_t depth = 0;
+
+        stats.operation(1);
+
+        while (node != nullptr) {
+            depth++;
+            if (compare(node->key, key)) {
+                node = node->right;
+            } else {
+                result = node;
+                node = node->left;
+            }
+        }
+
+        stats.depth(depth);
+
+        return skipDeleted(result);
+    }
+
+    /**
+     * Узел с первым ключом, большим заданного
+     * @param key ключ
+     * @return узел или nullptr
+     */
+    template <class Key>
+    Node<Type>* upperBoundNode(const Key& key) const {
+        Node<Type>* node = head;
+        Node<Type>* result = nullptr;
+        size_t depth = 0;
+
+        stats.operation(1);
+
+        while (node != nullptr) {
+            depth++;
+            if (compare(key, node->key)) {
+                result = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+
+        stats.depth(depth);
+
+        return skipDeleted(result);
+    }
+
+    /**
+     * Первый неудалённый узел, начиная с заданного
+     * @param node узел или nullptr
+     * @return узел или nullptr
+     */
+    Node<Type>* skipDeleted(Node<Type>* node) const {
+        iterator it(node, &head);
+
+        if (node != nullptr && node->deleted)
+            ++it;
+        return it.node;
+    }
+
+    /**
+     * Результат вставки существующего ключа
+     * (помеченный удалённым узел восстанавливается)
+     * @param node узел с ключом
+     * @return узел и признак того, что ключ был вставлен
+     */
+    std::pair<Node<Type>*, bool> existing(Node<Type>* node) {
+        if (!node->deleted)
+            return std::make_pair(node, false);
+
+        node->deleted = false;
+        for (Node<Type>* current = node; current != nullptr; current = current->parent)
+            current->size++;
+        size++;
+        tombstones--;
+        return std::make_pair(node, true);
+    }
+
+    /**
+     * Ленивое удаление: узел только помечается, размеры поддеревьев
+     * на пути к корню уменьшаются, повороты не выполняются
+     * @param key удаляемый ключ
+     * @return был ли ключ удалён
+     */
+    template <class Key>
+    bool markDeleted(const Key& key) {
+        Node<Type>* node = existNode(key);
+
+        if (node == nullptr)
+            return false;
+
+        node->deleted = true;
+        for (Node<Type>* current = node; current != nullptr; current = current->parent)
+            current->size--;
+        size--;
+        tombstones++;
+
+        if (tombstones > tombstoneLimit * (size + tombstones))
+            purge();
+        return true;
+    }
+
+    /**
+     * Вытягивание неудалённых узлов поддерева в список по возрастанию
+     * (список связан через right), помеченные узлы разрушаются
+     * @param node вершина поддерева
+     * @param tail ссылка на конец списка
+     */
+    void flatten(Node<Type>* node, Node<Type>**& tail) {
+        if (node == nullptr)
+            return;
+
+        Node<Type>* right = node->right;
+
+        flatten(node->left, tail);
+        if (node->deleted) {
+            destroyNode(node);
+        } else {
+            *tail = node;
+            tail = &node->right;
+        }
+        flatten(right, tail);
+    }
+
+    /**
+     * Построение сбалансированного поддерева из первых count узлов списка
+     * (узлы переиспользуются, память не выделяется)
+     * @param list начало списка (сдвигается)
+     * @param count количество узлов
+     * @param parent родитель вершины поддерева
+     * @return вершина поддерева
+     */
+    Node<Type>* buildFromList(Node<Type>*& list, size_t count, Node<Type>* parent) {
+        if (count == 0)
+            return nullptr;
+
+        size_t leftCount = count / 2;
+        Node<Type>* left = buildFromList(list, leftCount, nullptr);
+        Node<Type>* node = list;
+
+        list = list->right;
+        node->parent = parent;
+        node->left = left;
+        if (left != nullptr)
+            left->parent = node;
+        node->right = buildFromList(list, count - leftCount - 1, node);
+        update(node);
+
+        return node;
+    }
+
+    /**
+     * Результат вставки в виде итератора
+     * @param inserted узел и признак вставки
+     * @return итератор и признак вставки
+     */
+    std::pair<iterator, bool> result(std::pair<Node<Type>*, bool> inserted) const {
+        return std::make_pair(iterator(inserted.first, &head), inserted.second);
     }
 };
 
@@ -0,0 +1,818 @@
+#ifndef AVLTREE_BPLUSTREESET_H
+#define AVLTREE_BPLUSTREESET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Общая часть узлов B+ дерева
+ */
+struct BPlusNode {
+    size_t count; // количество ключей в узле
+
+    BPlusNode() : count(0) {}
+};
+
+/**
+ * Лист B+ дерева: упорядоченный массив ключей и ссылки на соседние листы
+ * Узел занимает несколько строк кэша (256 байт ключей)
+ * @tparam Type - тип хранимых ключей
+ */
+template <class Type>
+struct BPlusLeaf : BPlusNode {
+    static constexpr size_t Capacity = 256 / sizeof(Type) < 8 ? 8 : 256 / sizeof(Type);
+
+    Type keys[Capacity];  // ключи по возрастанию
+    BPlusLeaf* prev;      // предыдущий лист
+    BPlusLeaf* next;      // следующий лист
+
+    BPlusLeaf() : prev(nullptr), next(nullptr) {}
+};
+
+/**
+ * Внутренний узел B+ дерева: в поддереве children[i] лежат ключи
+ * из [keys[i - 1], keys[i])
+ * @tparam Type - тип хранимых ключей
+ */
+template <class Type>
+struct BPlusInner : BPlusNode {
+    static constexpr size_t Capacity = BPlusLeaf<Type>::Capacity;
+
+    Type keys[Capacity];                // разделители
+    BPlusNode* children[Capacity + 1];  // поддеревья
+};
+
+/**
+ * Поиск позиции ключа внутри узла: линейный подсчёт без ветвлений
+ * (на коротком массиве быстрее двоичного поиска)
+ * @tparam Type - тип ключей
+ * @tparam Compare - компаратор
+ */
+template <class Type, class Compare, class = void>
+struct NodeSearch {
+    /**
+     * Количество ключей, меньших заданного
+     */
+    static size_t countLess(const Type* keys, size_t count, const Type& key, const Compare& compare) {
+        size_t result = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            result += compare(keys[i], key);
+        return result;
+    }
+
+    /**
+     * Количество ключей, не больших заданного
+     */
+    static size_t countNotGreater(const Type* keys, size_t count, const Type& key, const Compare& compare) {
+        size_t result = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            result += !compare(key, keys[i]);
+        return result;
+    }
+};
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+
+/**
+ * Поиск в узле с SIMD для 32- и 64-битных целых со стандартным порядком:
+ * ключ сравнивается сразу с 8 (4) ключами узла командами AVX2
+ * (или с 4 (2) командами SSE4.2), совпадения накапливаются в векторе
+ */
+template <class Type, class Compare>
+struct NodeSearch<Type, Compare, typename std::enable_if<
+        std::is_integral<Type>::value && std::is_signed<Type>::value &&
+        (sizeof(Type) == 4 || sizeof(Type) == 8) &&
+        (std::is_same<Compare, std::less<Type>>::value || std::is_same<Compare, std::less<>>::value)>::type> {
+
+    static size_t countLess(const Type* keys, size_t count, const Type& key, const Compare&) {
+        // key > keys[i]
+        size_t i = 0;
+        size_t result = countVector<false>(keys, count, key, i);
+
+        for (; i < count; ++i)
+            result += keys[i] < key;
+        return result;
+    }
+
+    static size_t countNotGreater(const Type* keys, size_t count, const Type& key, const Compare&) {
+        // count - #(keys[i] > key)
+        size_t i = 0;
+        size_t greater = countVector<true>(keys, count, key, i);
+
+        for (; i < count; ++i)
+            greater += key < keys[i];
+        return count - greater;
+    }
+
+private:
+#if defined(__AVX2__)
+    using Vector = __m256i;
+
+    static Vector load(const Type* keys) {
+        return _mm256_loadu_si256(reinterpret_cast<const Vector*>(keys));
+    }
+
+    static Vector broadcast(Type key) {
+        return sizeof(Type) == 8 ? _mm256_set1_epi64x(key) : _mm256_set1_epi32(static_cast<int>(key));
+    }
+
+    static Vector greater(Vector lhs, Vector rhs) {
+        return sizeof(Type) == 8 ? _mm256_cmpgt_epi64(lhs, rhs) : _mm256_cmpgt_epi32(lhs, rhs);
+    }
+
+    static Vector subtract(Vector lhs, Vector rhs) {
+        return sizeof(Type) == 8 ? _mm256_sub_epi64(lhs, rhs) : _mm256_sub_epi32(lhs, rhs);
+    }
+
+    static Vector zero() {
+        return _mm256_setzero_si256();
+    }
+
+    static void store(Type* out, Vector value) {
+        _mm256_storeu_si256(reinterpret_cast<Vector*>(out), value);
+    }
+#else
+    using Vector = __m128i;
+
+    static Vector load(const Type* keys) {
+        return _mm_loadu_si128(reinterpret_cast<const Vector*>(keys));
+    }
+
+    static Vector broadcast(Type key) {
+        return sizeof(Type) == 8 ? _mm_set1_epi64x(key) : _mm_set1_epi32(static_cast<int>(key));
+    }
+
+    static Vector greater(Vector lhs, Vector rhs) {
+        return sizeof(Type) == 8 ? _mm_cmpgt_epi64(lhs, rhs) : _mm_cmpgt_epi32(lhs, rhs);
+    }
+
+    static Vector subtract(Vector lhs, Vector rhs) {
+        return sizeof(Type) == 8 ? _mm_sub_epi64(lhs, rhs) : _mm_sub_epi32(lhs, rhs);
+    }
+
+    static Vector zero() {
+        return _mm_setzero_si128();
+    }
+
+    static void store(Type* out, Vector value) {
+        _mm_storeu_si128(reinterpret_cast<Vector*>(out), value);
+    }
+#endif
+
+    /** Количество ключей в векторе */
+    static constexpr size_t Lanes = sizeof(Vector) / sizeof(Type);
+
+    /**
+     * Подсчёт по целым векторам (маска сравнения равна -1, поэтому вычитается)
+     * @tparam KeysGreater считать keys[i] > key (иначе key > keys[i])
+     * @param i сюда записывается первая необработанная позиция
+     */
+    template <bool KeysGreater>
+    static size_t countVector(const Type* keys, size_t count, Type key, size_t& i) {
+        Vector target = broadcast(key);
+        Vector sum = zero();
+
+        for (; i + Lanes <= count; i += Lanes) {
+            Vector block = load(keys + i);
+            sum = subtract(sum, KeysGreater ? greater(block, target) : greater(target, block));
+        }
+
+        Type lanes[Lanes];
+        size_t result = 0;
+
+        store(lanes, sum);
+        for (size_t lane = 0; lane < Lanes; ++lane)
+            result += static_cast<size_t>(lanes[lane]);
+        return result;
+    }
+};
+
+#endif
+
+/**
+ * Упорядоченное множество на B+ дереве с тем же интерфейсом, что у AVLTree
+ * Ключи лежат в широких узлах (256 байт), поэтому на уровень приходится
+ * один-два промаха кэша вместо одного на ключ, а высота в несколько раз меньше.
+ * Поиск внутри узла для целых ключей выполняется командами SIMD.
+ * Листья связаны в список, обход идёт по массивам подряд.
+ * @tparam Type - тип хранимых ключей (конструируемый по умолчанию)
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, class Compare = std::less<Type>>
+class BPlusTreeSet {
+public:
+
+    /**
+     * Двунаправленный итератор по ключам в порядке возрастания
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        Iterator() : tree(nullptr), leaf(nullptr), index(0) {}
+
+        reference operator*() const {
+            return leaf->keys[index];
+        }
+
+        pointer operator->() const {
+            return &leaf->keys[index];
+        }
+
+        Iterator& operator++() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        Iterator& operator--() {
+            // Уменьшение end() дает наибольший ключ
+            if (leaf == nullptr) {
+                leaf = tree->last;
+                index = leaf->count - 1;
+            } else if (index == 0) {
+                leaf = leaf->prev;
+                index = leaf->count - 1;
+            } else {
+                index--;
+            }
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return leaf == rhs.leaf && index == rhs.index;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        friend class BPlusTreeSet;
+
+        /** Множество, нужно для перехода от end() назад */
+        const BPlusTreeSet* tree;
+        /** Текущий лист (nullptr для end()) */
+        const BPlusLeaf<Type>* leaf;
+        /** Позиция в листе */
+        size_t index;
+
+        Iterator(const BPlusTreeSet* tree, const BPlusLeaf<Type>* leaf, size_t index)
+            : tree(tree), leaf(leaf), index(index) {}
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    /**
+     * Конструктор по умолчанию
+     */
+    BPlusTreeSet() : root(nullptr), first(nullptr), last(nullptr), levels(0), size(0) {}
+
+    BPlusTreeSet(const BPlusTreeSet&) = delete;
+    BPlusTreeSet& operator=(const BPlusTreeSet&) = delete;
+
+    /**
+     * Деструктор
+     */
+    ~BPlusTreeSet() {
+        clear();
+    }
+
+    /**
+     * Вставка ключа
+     * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    std::pair<iterator, bool> insert(const Type& key) {
+        if (root == nullptr) {
+            Leaf* leaf = new Leaf();
+
+            leaf->keys[0] = key;
+            leaf->count = 1;
+            root = first = last = leaf;
+            size = 1;
+            return std::make_pair(iterator(this, leaf, 0), true);
+        }
+
+        Inner* path[MaxLevels];
+        size_t slots[MaxLevels];
+        Leaf* leaf = descend(key, path, slots);
+        size_t position = Search::countLess(leaf->keys, leaf->count, key, compare);
+
+        if (position < leaf->count && !compare(key, leaf->keys[position]))
+            return std::make_pair(iterator(this, leaf, position), false); // Ключ уже есть
+
+        size++;
+
+        if (leaf->count < Capacity) {
+            insertAt(leaf->keys, leaf->count, position, key);
+            leaf->count++;
+            return std::make_pair(iterator(this, leaf, position), true);
+        }
+
+        // Переполненный лист делится пополам
+        Leaf* right = new Leaf();
+        size_t leftCount = (Capacity + 1) / 2;
+        iterator result;
+
+        if (position < leftCount) {
+            std::move(leaf->keys + leftCount - 1, leaf->keys + Capacity, right->keys);
+            right->count = Capacity - leftCount + 1;
+            insertAt(leaf->keys, leftCount - 1, position, key);
+            result = iterator(this, leaf, position);
+        } else {
+            std::move(leaf->keys + leftCount, leaf->keys + Capacity, right->keys);
+            right->count = Capacity - leftCount;
+            insertAt(right->keys, right->count, position - leftCount, key);
+            right->count++;
+            result = iterator(this, right, position - leftCount);
+        }
+        leaf->count = leftCount;
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next != nullptr)
+            leaf->next->prev = right;
+        else
+            last = right;
+        leaf->next = right;
+
+        insertSeparator(path, slots, right->keys[0], right);
+        return std::make_pair(result, true);
+    }
+
+    /**
+     * Удаления ключа
+     * @param key - ключ
+     * @return был ли ключ удалён
+     */
+    bool remove(const Type& key) {
+        if (root == nullptr)
+            return false;
+
+        Inner* path[MaxLevels];
+        size_t slots[MaxLevels];
+        Leaf* leaf = descend(key, path, slots);
+        size_t position = Search::countLess(leaf->keys, leaf->count, key, compare);
+
+        if (position == leaf->count || compare(key, leaf->keys[position]))
+            return false;
+
+        eraseAt(leaf->keys, leaf->count, position);
+        leaf->count--;
+        size--;
+
+        if (levels == 0) {
+            if (leaf->count == 0) {
+                delete leaf;
+                root = first = last = nullptr;
+            }
+            return true;
+        }
+
+        if (leaf->count >= MinCount)
+            return true;
+
+        // Недозаполненный лист занимает ключ у соседа или сливается с ним,
+        // слияние может сделать недозаполненным родителя
+        bool merged = rebalanceLeaf(leaf, path[levels - 1], slots[levels - 1]);
+
+        for (size_t level = levels - 1; merged && level > 0; --level) {
+            if (path[level]->count >= MinCount)
+                break;
+            merged = rebalanceInner(path[level], path[level - 1], slots[level - 1]);
+        }
+
+        // Корень без ключей заменяется единственным потомком
+        if (root->count == 0) {
+            Inner* top = static_cast<Inner*>(root);
+
+            root = top->children[0];
+            delete top;
+            levels--;
+        }
+
+        return true;
+    }
+
+    /**
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Type& key) const {
+        if (root == nullptr)
+            return false;
+
+        const Leaf* leaf = findLeaf(key);
+        size_t position = Search::countLess(leaf->keys, leaf->count, key, compare);
+
+        return position < leaf->count && !compare(key, leaf->keys[position]);
+    }
+
+    /**
+     * Поиск ключа
+     * @param key ключ
+     * @return итератор на ключ или end()
+     */
+    iterator find(const Type& key) const {
+        iterator it = lower_bound(key);
+
+        if (it != end() && compare(key, *it))
+            return end();
+        return it;
+    }
+
+    /**
+     * Первый ключ, не меньший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator lower_bound(const Type& key) const {
+        if (root == nullptr)
+            return end();
+
+        const Leaf* leaf = findLeaf(key);
+        return position(leaf, Search::countLess(leaf->keys, leaf->count, key, compare));
+    }
+
+    /**
+     * Первый ключ, больший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator upper_bound(const Type& key) const {
+        if (root == nullptr)
+            return end();
+
+        const Leaf* leaf = findLeaf(key);
+        return position(leaf, Search::countNotGreater(leaf->keys, leaf->count, key, compare));
+    }
+
+    /**
+     * Обход ключей из отрезка [lo, hi] в порядке возрастания
+     * (по массивам листов, связанных в список)
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @param visitor функция, вызываемая для каждого ключа
+     */
+    template <class Visitor>
+    void range(const Type& lo, const Type& hi, Visitor visitor) const {
+        iterator it = lower_bound(lo);
+        size_t index = it.index;
+
+        for (const Leaf* leaf = it.leaf; leaf != nullptr; leaf = leaf->next, index = 0) {
+            for (; index < leaf->count; ++index) {
+                if (compare(hi, leaf->keys[index]))
+                    return;
+                visitor(leaf->keys[index]);
+            }
+        }
+    }
+
+    /**
+     * Итератор на наименьший ключ
+     */
+    iterator begin() const {
+        return iterator(this, first, 0);
+    }
+
+    /**
+     * Итератор за наибольшим ключом
+     */
+    iterator end() const {
+        return iterator(this, nullptr, 0);
+    }
+
+    /**
+     * Удаление всех ключей
+     */
+    void clear() {
+        if (root != nullptr)
+            destroyNode(root, levels);
+
+        root = first = last = nullptr;
+        levels = 0;
+        size = 0;
+    }
+
+    /**
+     * Количество ключей
+     * @return размер множества
+     */
+    size_t getSize() const {
+        return size;
+    }
+
+private:
+    using Leaf = BPlusLeaf<Type>;
+    using Inner = BPlusInner<Type>;
+    using Search = NodeSearch<Type, Compare>;
+
+    /** Наибольшее количество ключей в узле */
+    static constexpr size_t Capacity = Leaf::Capacity;
+    /** Наименьшее количество ключей в узле, кроме корня */
+    static constexpr size_t MinCount = Capacity / 2;
+    /** Наибольшее количество внутренних уровней */
+    static constexpr size_t MaxLevels = 32;
+
+    /** Корень (лист, если levels == 0) */
+    BPlusNode* root;
+    /** Первый лист */
+    Leaf* first;
+    /** Последний лист */
+    Leaf* last;
+    /** Количество уровней внутренних узлов */
+    size_t levels;
+    /** Количество ключей */
+    size_t size;
+    /** Компаратор для упорядочивания элемментов */
+    Compare compare;
+
+    /**
+     * Вставка в массив со сдвигом
+     */
+    template <class T>
+    static void insertAt(T* array, size_t count, size_t position, const T& value) {
+        std::move_backward(array + position, array + count, array + count + 1);
+        array[position] = value;
+    }
+
+    /**
+     * Удаление из массива со сдвигом
+     */
+    template <class T>
+    static void eraseAt(T* array, size_t count, size_t position) {
+        std::move(array + position + 1, array + count, array + position);
+    }
+
+    /**
+     * Спуск к листу, в котором должен лежать ключ
+     * @param key ключ
+     * @return лист
+     */
+    const Leaf* findLeaf(const Type& key) const {
+        const BPlusNode* node = root;
+
+        for (size_t level = 0; level < levels; ++level) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node = inner->children[Search::countNotGreater(inner->keys, inner->count, key, compare)];
+        }
+
+        return static_cast<const Leaf*>(node);
+    }
+
+    /**
+     * Спуск к листу с запоминанием пути
+     * @param key ключ
+     * @param path внутренние узлы пути от корня
+     * @param slots номера потомков, по которым шёл спуск
+     * @return лист
+     */
+    Leaf* descend(const Type& key, Inner** path, size_t* slots) {
+        BPlusNode* node = root;
+
+        for (size_t level = 0; level < levels; ++level) {
+            Inner* inner = static_cast<Inner*>(node);
+            size_t slot = Search::countNotGreater(inner->keys, inner->count, key, compare);
+
+            path[level] = inner;
+            slots[level] = slot;
+            node = inner->children[slot];
+        }
+
+        return static_cast<Leaf*>(node);
+    }
+
+    /**
+     * Итератор на позицию в листе (позиция за концом листа - начало следующего)
+     */
+    iterator position(const Leaf* leaf, size_t index) const {
+        if (index == leaf->count)
+            return iterator(this, leaf->next, 0);
+        return iterator(this, leaf, index);
+    }
+
+    /**
+     * Добавление разделителя и нового правого узла в родителей
+     * с разделением переполненных внутренних узлов
+     * @param path внутренние узлы пути от корня
+     * @param slots номера потомков, по которым шёл спуск
+     * @param separator наименьший ключ нового узла
+     * @param child новый узел
+     */
+    void insertSeparator(Inner** path, size_t* slots, Type separator, BPlusNode* child) {
+        for (size_t level = levels; level-- > 0;) {
+            Inner* inner = path[level];
+            size_t slot = slots[level];
+
+            if (inner->count < Capacity) {
+                insertAt(inner->keys, inner->count, slot, separator);
+                insertAt(inner->children, inner->count + 1, slot + 1, child);
+                inner->count++;
+                return;
+            }
+
+            // Переполненный узел делится, средний ключ поднимается выше
+            Type keys[Capacity + 1];
+            BPlusNode* children[Capacity + 2];
+
+            std::move(inner->keys, inner->keys + Capacity, keys);
+            std::copy(inner->children, inner->children + Capacity + 1, children);
+            insertAt(keys, Capacity, slot, separator);
+            insertAt(children, Capacity + 1, slot + 1, child);
+
+            Inner* right = new Inner();
+            size_t leftCount = Capacity / 2;
+
+            inner->count = leftCount;
+            std::move(keys, keys + leftCount, inner->keys);
+            std::copy(children, children + leftCount + 1, inner->children);
+
+            right->count = Capacity - leftCount;
+            std::move(keys + leftCount + 1, keys + Capacity + 1, right->keys);
+            std::copy(children + leftCount + 1, children + Capacity + 2, right->children);
+
+            separator = std::move(keys[leftCount]);
+            child = right;
+        }
+
+        // Разделился корень - дерево растёт вверх
+        Inner* top = new Inner();
+
+        top->keys[0] = separator;
+        top->children[0] = root;
+        top->children[1] = child;
+        top->count = 1;
+        root = top;
+        levels++;
+    }
+
+    /**
+     * Удаление разделителя и правого от него потомка
+     */
+    static void removeChild(Inner* parent, size_t keyIndex) {
+        eraseAt(parent->keys, parent->count, keyIndex);
+        eraseAt(parent->children, parent->count + 1, keyIndex + 1);
+        parent->count--;
+    }
+
+    /**
+     * Восстановление заполненности листа
+     * @param leaf недозаполненный лист
+     * @param parent родитель
+     * @param slot номер листа у родителя
+     * @return произошло ли слияние (родитель потерял потомка)
+     */
+    bool rebalanceLeaf(Leaf* leaf, Inner* parent, size_t slot) {
+        Leaf* left = slot > 0 ? static_cast<Leaf*>(parent->children[slot - 1]) : nullptr;
+        Leaf* right = slot < parent->count ? static_cast<Leaf*>(parent->children[slot + 1]) : nullptr;
+
+        if (left != nullptr && left->count > MinCount) {
+            insertAt(leaf->keys, leaf->count, 0, left->keys[left->count - 1]);
+            left->count--;
+            leaf->count++;
+            parent->keys[slot - 1] = leaf->keys[0];
+            return false;
+        }
+
+        if (right != nullptr && right->count > MinCount) {
+            leaf->keys[leaf->count++] = right->keys[0];
+            eraseAt(right->keys, right->count, 0);
+            right->count--;
+            parent->keys[slot] = right->keys[0];
+            return false;
+        }
+
+        if (left != nullptr) {
+            mergeLeaves(left, leaf);
+            removeChild(parent, slot - 1);
+        } else {
+            mergeLeaves(leaf, right);
+            removeChild(parent, slot);
+        }
+
+        return true;
+    }
+
+    /**
+     * Слияние листа с правым соседом
+     */
+    void mergeLeaves(Leaf* left, Leaf* right) {
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        left->count += right->count;
+
+        left->next = right->next;
+        if (right->next != nullptr)
+            right->next->prev = left;
+        else
+            last = left;
+
+        delete right;
+    }
+
+    /**
+     * Восстановление заполненности внутреннего узла
+     * @param node недозаполненный узел
+     * @param parent родитель
+     * @param slot номер узла у родителя
+     * @return произошло ли слияние (родитель потерял потомка)
+     */
+    bool rebalanceInner(Inner* node, Inner* parent, size_t slot) {
+        Inner* left = slot > 0 ? static_cast<Inner*>(parent->children[slot - 1]) : nullptr;
+        Inner* right = slot < parent->count ? static_cast<Inner*>(parent->children[slot + 1]) : nullptr;
+
+        // Занимаем крайнего потомка соседа через разделитель родителя
+        if (left != nullptr && left->count > MinCount) {
+            insertAt(node->keys, node->count, 0, parent->keys[slot - 1]);
+            insertAt(node->children, node->count + 1, 0, left->children[left->count]);
+            parent->keys[slot - 1] = left->keys[left->count - 1];
+            left->count--;
+            node->count++;
+            return false;
+        }
+
+        if (right != nullptr && right->count > MinCount) {
+            node->keys[node->count] = parent->keys[slot];
+            node->children[node->count + 1] = right->children[0];
+            node->count++;
+            parent->keys[slot] = right->keys[0];
+            eraseAt(right->keys, right->count, 0);
+            eraseAt(right->children, right->count + 1, 0);
+            right->count--;
+            return false;
+        }
+
+        if (left != nullptr) {
+            mergeInner(left, parent->keys[slot - 1], node);
+            removeChild(parent, slot - 1);
+        } else {
+            mergeInner(node, parent->keys[slot], right);
+            removeChild(parent, slot);
+        }
+
+        return true;
+    }
+
+    /**
+     * Слияние внутреннего узла с правым соседом через разделитель родителя
+     */
+    static void mergeInner(Inner* left, const Type& separator, Inner* right) {
+        left->keys[left->count] = separator;
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+
+        delete right;
+    }
+
+    /**
+     * Удаление поддерева
+     * @param node вершина поддерева
+     * @param level количество внутренних уровней в поддереве
+     */
+    static void destroyNode(BPlusNode* node, size_t level) {
+        if (level == 0) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+
+        for (size_t i = 0; i <= inner->count; ++i)
+            destroyNode(inner->children[i], level - 1);
+        delete inner;
+    }
+};
+
+#endif //AVLTREE_BPLUSTREESET_H
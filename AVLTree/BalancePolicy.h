@@ -0,0 +1,29 @@
+#ifndef AVLTREE_BALANCEPOLICY_H
+#define AVLTREE_BALANCEPOLICY_H
+
+/**
+ * Классическая AVL балансировка (по умолчанию)
+ * В узле хранится высота поддерева, высоты потомков отличаются не более
+ * чем на 1. Удаление может выполнить O(Lg(n)) поворотов.
+ */
+struct AVLBalance {
+    /** Высота узла вычисляется по потомкам */
+    static constexpr bool rankBalanced = false;
+};
+
+/**
+ * Слабая AVL балансировка (WAVL, rank-balanced)
+ * В поле высоты хранится ранг: разность рангов родителя и потомка 1 или 2
+ * (у отсутствующего потомка ранг 0), лист имеет ранг 1. Вставка
+ * балансируется так же, как в AVL дереве, а удаление выполняет не более
+ * двух поворотов и амортизированно O(1) изменений рангов. Дерево без
+ * удалений остаётся AVL деревом, высота не больше 2*Lg(n).
+ * Соединение, разделение и операции над множествами требуют
+ * AVL балансировки.
+ */
+struct WAVLBalance {
+    /** Ранг узла изменяется только явно при балансировке */
+    static constexpr bool rankBalanced = true;
+};
+
+#endif //AVLTREE_BALANCEPOLICY_H
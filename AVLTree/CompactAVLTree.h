@@ -0,0 +1,783 @@
+#ifndef AVLTREE_COMPACTAVLTREE_H
+#define AVLTREE_COMPACTAVLTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Компактный узел дерева: вместо указателей индексы в массиве узлов
+ * (для 8-байтного ключа узел занимает 32 байта вместо 48)
+ * @tparam Type - тип хранимого ключа
+ */
+template <class Type>
+struct CompactNode {
+    Type key;        // ключ
+    uint32_t left;   // индекс левого поддерева
+    uint32_t right;  // индекс правого поддерева
+    uint32_t parent; // индекс родителя
+    uint32_t size;   // количество узлов в поддереве
+    int8_t height;   // высота дерева от данного узла
+};
+
+/**
+ * AVL дерево с компактным расположением узлов
+ * Узлы хранятся в одном массиве, связи и размеры поддеревьев -
+ * 32-битные индексы, высота - 8 бит. Вмещает до 2^32 - 1 ключей,
+ * при переполнении вставка бросает std::length_error.
+ * Интерфейс совпадает с AVLTree (вставка, удаление, поиск, в том числе
+ * по ключу другого типа для прозрачного компаратора, порядковые статистики).
+ * @tparam Type - тип хранимых ключей
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, class Compare = std::less<Type>>
+class CompactAVLTree {
+public:
+
+    /**
+     * Двунаправленный итератор по ключам в порядке возрастания
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        Iterator() : tree(nullptr), index(Null) {}
+
+        reference operator*() const {
+            return tree->nodes[index].key;
+        }
+
+        pointer operator->() const {
+            return &tree->nodes[index].key;
+        }
+
+        Iterator& operator++() {
+            const std::vector<CompactNode<Type>>& nodes = tree->nodes;
+
+            if (nodes[index].right != Null) {
+                index = nodes[index].right;
+                while (nodes[index].left != Null)
+                    index = nodes[index].left;
+            } else {
+                uint32_t previous = index;
+                index = nodes[index].parent;
+                while (index != Null && nodes[index].right == previous) {
+                    previous = index;
+                    index = nodes[index].parent;
+                }
+            }
+
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        Iterator& operator--() {
+            const std::vector<CompactNode<Type>>& nodes = tree->nodes;
+
+            if (index == Null) {
+                index = tree->root;
+                while (nodes[index].right != Null)
+                    index = nodes[index].right;
+            } else if (nodes[index].left != Null) {
+                index = nodes[index].left;
+                while (nodes[index].right != Null)
+                    index = nodes[index].right;
+            } else {
+                uint32_t previous = index;
+                index = nodes[index].parent;
+                while (index != Null && nodes[index].left == previous) {
+                    previous = index;
+                    index = nodes[index].parent;
+                }
+            }
+
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return index == rhs.index;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return index != rhs.index;
+        }
+
+    private:
+        friend class CompactAVLTree;
+
+        /** Дерево */
+        const CompactAVLTree* tree;
+        /** Индекс текущего узла (Null для end()) */
+        uint32_t index;
+
+        Iterator(const CompactAVLTree* tree, uint32_t index) : tree(tree), index(index) {}
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    /**
+     * Конструктор по умолчанию
+     */
+    CompactAVLTree() {
+        root = Null;
+        freeList = Null;
+        size = 0;
+    }
+
+    /**
+     * Вставка ключа в дерево
+     * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    std::pair<iterator, bool> insert(const Type& key) {
+        return insertKey(key);
+    }
+
+    /**
+     * Вставка ключа в дерево с перемещением
+     * (ключ перемещается, только если его ещё нет в дереве)
+     * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    std::pair<iterator, bool> insert(Type&& key) {
+        return insertKey(std::move(key));
+    }
+
+    /**
+     * Вставка ключа, сконструированного из аргументов
+     * (ключ создаётся до поиска места и перемещается в узел)
+     * @param args аргументы конструктора ключа
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insertKey(Type(std::forward<Args>(args)...));
+    }
+
+    /**
+     * Удаления ключа из дерева
+     * @param key - ключ
+     * @return был ли ключ удалён
+     */
+    bool remove(const Type& key) {
+        return deleteKey(key);
+    }
+
+    /**
+     * Удаление по ключу другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    bool remove(const Key& key) {
+        return deleteKey(key);
+    }
+
+    /**
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Type& key) const {
+        return findIndex(key) != Null;
+    }
+
+    /**
+     * Проверка по ключу другого типа без создания временного Type
+     * (для прозрачного компаратора, например std::less<>)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    bool exist(const Key& key) const {
+        return findIndex(key) != Null;
+    }
+
+    /**
+     * Поиск ключа
+     * @param key ключ
+     * @return итератор на ключ или end()
+     */
+    iterator find(const Type& key) const {
+        return iterator(this, findIndex(key));
+    }
+
+    /**
+     * Поиск по ключу другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator find(const Key& key) const {
+        return iterator(this, findIndex(key));
+    }
+
+    /**
+     * Первый ключ, не меньший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator lower_bound(const Type& key) const {
+        return iterator(this, lowerBoundIndex(key));
+    }
+
+    /**
+     * Первый ключ, не меньший ключа другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator lower_bound(const Key& key) const {
+        return iterator(this, lowerBoundIndex(key));
+    }
+
+    /**
+     * Первый ключ, больший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator upper_bound(const Type& key) const {
+        return iterator(this, upperBoundIndex(key));
+    }
+
+    /**
+     * Первый ключ, больший ключа другого типа (для прозрачного компаратора)
+     */
+    template <class Key, class C = Compare, class = typename C::is_transparent>
+    iterator upper_bound(const Key& key) const {
+        return iterator(this, upperBoundIndex(key));
+    }
+
+    /**
+     * Порядковая статистика: количество ключей, меньших заданного
+     * @param key ключ
+     * @return позиция ключа (или места его вставки) в отсортированном порядке
+     */
+    size_t rank(const Type& key) const {
+        uint32_t current = root;
+        size_t result = 0;
+
+        while (current != Null) {
+            const CompactNode<Type>& node = nodes[current];
+
+            if (compare(node.key, key)) {
+                result += subtreeSize(node.left) + 1;
+                current = node.right;
+            } else {
+                current = node.left;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Ключ, стоящий на заданной позиции в отсортированном порядке
+     * @param k позиция (с нуля)
+     * @return итератор на ключ или end(), если k >= количества ключей
+     */
+    iterator select(size_t k) const {
+        uint32_t current = root;
+
+        while (current != Null) {
+            size_t leftSize = subtreeSize(nodes[current].left);
+
+            if (k < leftSize) {
+                current = nodes[current].left;
+            } else if (k == leftSize) {
+                break;
+            } else {
+                k -= leftSize + 1;
+                current = nodes[current].right;
+            }
+        }
+
+        return iterator(this, current);
+    }
+
+    /**
+     * Количество ключей из отрезка [lo, hi]
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @return количество ключей
+     */
+    size_t count(const Type& lo, const Type& hi) const {
+        if (compare(hi, lo))
+            return 0;
+
+        // Количество ключей, не больших hi
+        uint32_t current = root;
+        size_t notGreater = 0;
+
+        while (current != Null) {
+            const CompactNode<Type>& node = nodes[current];
+
+            if (compare(hi, node.key)) {
+                current = node.left;
+            } else {
+                notGreater += subtreeSize(node.left) + 1;
+                current = node.right;
+            }
+        }
+
+        return notGreater - rank(lo);
+    }
+
+    /**
+     * Обход ключей из отрезка [lo, hi] в порядке возрастания
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @param visitor функция, вызываемая для каждого ключа
+     */
+    template <class Visitor>
+    void range(const Type& lo, const Type& hi, Visitor visitor) const {
+        for (iterator it = lower_bound(lo); it != end() && !compare(hi, *it); ++it)
+            visitor(*it);
+    }
+
+    /**
+     * Итератор на наименьший ключ
+     */
+    iterator begin() const {
+        uint32_t current = root;
+
+        if (current != Null)
+            while (nodes[current].left != Null)
+                current = nodes[current].left;
+
+        return iterator(this, current);
+    }
+
+    /**
+     * Итератор за наибольшим ключом
+     */
+    iterator end() const {
+        return iterator(this, Null);
+    }
+
+    /**
+     * Резервирование памяти под заданное количество узлов
+     * @param count количество узлов
+     */
+    void reserve(size_t count) {
+        nodes.reserve(count);
+    }
+
+    /**
+     * Удаление всех ключей из дерева
+     */
+    void clear() {
+        nodes.clear();
+        root = Null;
+        freeList = Null;
+        size = 0;
+    }
+
+    /**
+     * Количество ключей в дереве
+     * @return размер дерева
+     */
+    size_t getSize() const {
+        return size;
+    }
+
+private:
+    /** Отсутствующий узел */
+    static constexpr uint32_t Null = UINT32_MAX;
+    /** Максимальная высота дерева (AVL дерево из 2^32 узлов ниже 47 уровней) */
+    static constexpr size_t MaxHeight = 48;
+
+    /** Массив узлов (удалённые узлы связаны в список свободных через left) */
+    std::vector<CompactNode<Type>> nodes;
+    /** Индекс корня */
+    uint32_t root;
+    /** Начало списка свободных узлов */
+    uint32_t freeList;
+    /** Размер дерева */
+    size_t size;
+    /** Компаратор для упорядочивания элемментов */
+    Compare compare;
+
+    /**
+     * Ссылка на узел пути: корень или поле потомка предыдущего узла
+     * @param path узлы пути от корня
+     * @param toRight направления спуска
+     * @param depth позиция в пути
+     * @return ссылка на индекс
+     */
+    uint32_t& link(const uint32_t path[], const bool toRight[], size_t depth) {
+        if (depth == 0)
+            return root;
+
+        CompactNode<Type>& parent = nodes[path[depth - 1]];
+        return toRight[depth - 1] ? parent.right : parent.left;
+    }
+
+    /**
+     * Создание листа (из списка свободных или в конце массива)
+     * @param key ключ
+     * @param parent индекс родителя
+     * @return индекс нового узла
+     * @throws std::length_error если индексы узлов исчерпаны
+     */
+    template <class Key>
+    uint32_t createNode(Key&& key, uint32_t parent) {
+        uint32_t index;
+
+        if (freeList != Null) {
+            index = freeList;
+            freeList = nodes[index].left;
+            nodes[index].key = std::forward<Key>(key);
+        } else {
+            // Индекс Null зарезервирован под отсутствующий узел
+            if (nodes.size() >= Null)
+                throw std::length_error("CompactAVLTree: node index overflow");
+
+            index = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(CompactNode<Type>{std::forward<Key>(key), Null, Null, Null, 1, 1});
+        }
+
+        CompactNode<Type>& node = nodes[index];
+        node.left = Null;
+        node.right = Null;
+        node.parent = parent;
+        node.size = 1;
+        node.height = 1;
+        return index;
+    }
+
+    /**
+     * Возврат узла в список свободных
+     * @param index индекс узла
+     */
+    void destroyNode(uint32_t index) {
+        nodes[index].left = freeList;
+        freeList = index;
+    }
+
+    int8_t height(uint32_t index) const {
+        return index == Null ? 0 : nodes[index].height;
+    }
+
+    size_t subtreeSize(uint32_t index) const {
+        return index == Null ? 0 : nodes[index].size;
+    }
+
+    int getBalance(uint32_t index) const {
+        return index == Null ? 0 : height(nodes[index].left) - height(nodes[index].right);
+    }
+
+    /**
+     * Пересчёт высоты и размера по потомкам
+     * @param index индекс узла
+     */
+    void update(uint32_t index) {
+        CompactNode<Type>& node = nodes[index];
+        int8_t left = height(node.left);
+        int8_t right = height(node.right);
+
+        node.height = static_cast<int8_t>((left > right ? left : right) + 1);
+        node.size = static_cast<uint32_t>(subtreeSize(node.left) + subtreeSize(node.right) + 1);
+    }
+
+    /**
+     * Малый левый поворот
+     * @param index ссылка на узел у которого выполняем поворот
+     */
+    void leftRotate(uint32_t& index) {
+        uint32_t node = index;
+        uint32_t result = nodes[node].right;
+        uint32_t tmp = nodes[result].left;
+
+        // Изменяем потомков
+        nodes[result].left = node;
+        nodes[node].right = tmp;
+
+        // Изменяем родителей
+        nodes[result].parent = nodes[node].parent;
+        nodes[node].parent = result;
+        if (tmp != Null)
+            nodes[tmp].parent = node;
+
+        update(node);
+        update(result);
+
+        // Присваивание нового корня
+        index = result;
+    }
+
+    /**
+     * Малый правый поворот
+     * @param index ссылка на узел у которого выполняем поворот
+     */
+    void rightRotate(uint32_t& index) {
+        uint32_t node = index;
+        uint32_t result = nodes[node].left;
+        uint32_t tmp = nodes[result].right;
+
+        // Изменяем потомков
+        nodes[result].right = node;
+        nodes[node].left = tmp;
+
+        // Изменяем родителей
+        nodes[result].parent = nodes[node].parent;
+        nodes[node].parent = result;
+        if (tmp != Null)
+            nodes[tmp].parent = node;
+
+        update(node);
+        update(result);
+
+        // Присваивание нового корня
+        index = result;
+    }
+
+    /**
+     * Вставка ключа (копированием или перемещением)
+     * @param key - ключ
+     * @return итератор на ключ и признак того, что ключ был вставлен
+     */
+    template <class Key>
+    std::pair<iterator, bool> insertKey(Key&& key) {
+        uint32_t path[MaxHeight]; // Узлы пути от корня
+        bool toRight[MaxHeight];  // В какое поддерево узла пути продолжился спуск
+        size_t depth = 0;
+        uint32_t current = root;
+
+        // Спускаемся вниз по дереву
+        while (current != Null) {
+            const CompactNode<Type>& node = nodes[current];
+            bool less = compare(key, node.key);
+
+            if (!less && !compare(node.key, key))
+                return {iterator(this, current), false}; // Ключ уже есть в дереве
+
+            path[depth] = current;
+            toRight[depth] = !less;
+            current = less ? node.left : node.right;
+            depth++;
+        }
+
+        // Выделение узла может переместить массив, поэтому путь хранит индексы
+        uint32_t created = createNode(std::forward<Key>(key), depth > 0 ? path[depth - 1] : Null);
+        link(path, toRight, depth) = created;
+        size++;
+
+        // Подъём с восстановлением баланса
+        while (depth > 0) {
+            uint32_t& index = link(path, toRight, --depth);
+            int8_t previous = nodes[index].height;
+
+            update(index);
+
+            int balance = getBalance(index);
+
+            if (balance > 1) {
+                if (getBalance(nodes[index].left) < 0)
+                    leftRotate(nodes[index].left);
+                rightRotate(index);
+                break;
+            }
+            if (balance < -1) {
+                if (getBalance(nodes[index].right) > 0)
+                    rightRotate(nodes[index].right);
+                leftRotate(index);
+                break;
+            }
+
+            if (nodes[index].height == previous)
+                break;
+        }
+
+        // Выше места остановки меняются только размеры поддеревьев
+        while (depth > 0)
+            nodes[path[--depth]].size++;
+
+        return {iterator(this, created), true};
+    }
+
+    /**
+     * Удаление ключа (в том числе ключа другого типа)
+     * @param key - ключ
+     * @return был ли ключ удалён
+     */
+    template <class Key>
+    bool deleteKey(const Key& key) {
+        uint32_t path[MaxHeight];
+        bool toRight[MaxHeight];
+        size_t depth = 0;
+        uint32_t current = root;
+
+        // Поиск удаляемого узла
+        while (current != Null) {
+            const CompactNode<Type>& node = nodes[current];
+            bool less = compare(key, node.key);
+
+            if (!less && !compare(node.key, key))
+                break;
+
+            path[depth] = current;
+            toRight[depth] = !less;
+            current = less ? node.left : node.right;
+            depth++;
+        }
+
+        if (current == Null)
+            return false;
+
+        CompactNode<Type>& node = nodes[current];
+
+        if (node.left == Null || node.right == Null) {
+            uint32_t child = node.left != Null ? node.left : node.right;
+
+            if (child != Null)
+                nodes[child].parent = node.parent;
+            link(path, toRight, depth) = child;
+        } else {
+            size_t nodeDepth = depth;
+
+            // Спуск к следующему по возрастанию узлу
+            path[depth] = current;
+            toRight[depth] = true;
+            depth++;
+
+            uint32_t successor = node.right;
+            while (nodes[successor].left != Null) {
+                path[depth] = successor;
+                toRight[depth] = false;
+                depth++;
+                successor = nodes[successor].left;
+            }
+
+            // Вырезаем преемника и ставим его на место удаляемого узла
+            CompactNode<Type>& next = nodes[successor];
+            link(path, toRight, depth) = next.right;
+            if (next.right != Null)
+                nodes[next.right].parent = next.parent;
+
+            next.left = node.left;
+            next.right = node.right;
+            next.parent = node.parent;
+            next.height = node.height;
+            next.size = node.size;
+            nodes[next.left].parent = successor;
+            if (next.right != Null)
+                nodes[next.right].parent = successor;
+            link(path, toRight, nodeDepth) = successor;
+            path[nodeDepth] = successor;
+        }
+
+        destroyNode(current);
+        size--;
+
+        // Подъём с восстановлением баланса
+        while (depth > 0) {
+            uint32_t& index = link(path, toRight, --depth);
+            int8_t previous = nodes[index].height;
+
+            update(index);
+
+            int balance = getBalance(index);
+
+            if (balance > 1) {
+                if (getBalance(nodes[index].left) < 0)
+                    leftRotate(nodes[index].left);
+                rightRotate(index);
+            } else if (balance < -1) {
+                if (getBalance(nodes[index].right) > 0)
+                    rightRotate(nodes[index].right);
+                leftRotate(index);
+            }
+
+            if (nodes[index].height == previous)
+                break;
+        }
+
+        // Выше места остановки меняются только размеры поддеревьев
+        while (depth > 0)
+            nodes[path[--depth]].size--;
+
+        return true;
+    }
+
+    /**
+     * Поиск узла с заданным ключом
+     * @param key ключ
+     * @return индекс узла или Null
+     */
+    template <class Key>
+    uint32_t findIndex(const Key& key) const {
+        uint32_t current = root;
+
+        while (current != Null) {
+            const CompactNode<Type>& node = nodes[current];
+
+            if (compare(key, node.key))
+                current = node.left;
+            else if (compare(node.key, key))
+                current = node.right;
+            else
+                break;
+        }
+
+        return current;
+    }
+
+    /**
+     * Индекс первого ключа, не меньшего заданного
+     * @param key ключ
+     * @return индекс узла или Null
+     */
+    template <class Key>
+    uint32_t lowerBoundIndex(const Key& key) const {
+        uint32_t current = root;
+        uint32_t result = Null;
+
+        while (current != Null) {
+            if (compare(nodes[current].key, key)) {
+                current = nodes[current].right;
+            } else {
+                result = current;
+                current = nodes[current].left;
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Индекс первого ключа, большего заданного
+     * @param key ключ
+     * @return индекс узла или Null
+     */
+    template <class Key>
+    uint32_t upperBoundIndex(const Key& key) const {
+        uint32_t current = root;
+        uint32_t result = Null;
+
+        while (current != Null) {
+            if (compare(key, nodes[current].key)) {
+                result = current;
+                current = nodes[current].left;
+            } else {
+                current = nodes[current].right;
+            }
+        }
+
+        return result;
+    }
+};
+
+#endif //AVLTREE_COMPACTAVLTREE_H
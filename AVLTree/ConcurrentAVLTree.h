@@ -0,0 +1,731 @@
+#ifndef AVLTREE_CONCURRENTAVLTREE_H
+#define AVLTREE_CONCURRENTAVLTREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * Узел конкурентного дерева
+ * Ключ не меняется после публикации узла. Указатели, версия, признак
+ * наличия ключа и высота читаются без блокировок, а меняются только
+ * под блокировкой узла (родитель - под блокировками прежнего и нового родителя).
+ * @tparam Type - тип хранимого ключа
+ */
+template <class Type>
+struct ConcurrentNode {
+    const Type key;                         // ключ
+    std::atomic<ConcurrentNode*> left;      // указатель на левое поддерево
+    std::atomic<ConcurrentNode*> right;     // указатель на правое поддерево
+    std::atomic<ConcurrentNode*> parent;    // указатель на родителя
+    std::atomic<uint64_t> version;          // версия узла для оптимистичной проверки
+    std::atomic<int> height;                // высота дерева от данного узла (может временно отставать)
+    std::atomic<bool> present;              // есть ли ключ в множестве (иначе узел маршрутный)
+    std::mutex lock;                        // блокировка писателей
+
+    ConcurrentNode(const Type& key, ConcurrentNode* parent)
+        : key(key), left(nullptr), right(nullptr), parent(parent), version(0), height(1), present(true) {}
+};
+
+/**
+ * Конкурентное AVL дерево для многих читателей и нескольких писателей
+ * (схема Bronson et al. "A Practical Concurrent Binary Search Tree")
+ *
+ * Читатели не берут блокировок: спуск выполняется "из рук в руки"
+ * с оптимистичной проверкой версий. Поворот помечает опускаемый узел
+ * как сжимающийся и увеличивает его версию, поэтому поток, прошедший
+ * через такой узел, возвращается на уровень выше и повторяет шаг.
+ *
+ * Писатели спускаются так же, как читатели, а блокируют только узлы,
+ * которые меняют: вставка - родителя нового листа, удаление - сам узел
+ * (узел с двумя потомками остаётся маршрутным, без ключа). Затем
+ * высоты исправляются снизу вверх: для исправления высоты блокируется
+ * узел, для поворота или вырезания маршрутного узла - его родитель,
+ * сам узел и поднимаемые потомки. Блокировки всегда берутся сверху вниз
+ * по рёбрам дерева, а ниже первой - только попыткой (при неудаче все
+ * блокировки отпускаются и шаг повторяется), поэтому взаимных блокировок
+ * нет. После взятия блокировки узел проверяется: не вырезан ли он и не
+ * сменился ли родитель.
+ * Высоты на время одновременных изменений могут отставать (ослабленный
+ * баланс), каждый писатель доводит исправление до места, где высота
+ * перестала меняться.
+ *
+ * Вырезанные узлы освобождаются по эпохам (epoch-based reclamation):
+ * поток на время операции занимает слот и записывает в него текущую
+ * эпоху дерева. Вырезанный узел помечается эпохой, в которой он вырезан,
+ * эпоха переводится дальше, только когда все занятые слоты находятся
+ * в текущей эпохе. Узел, вырезанный в эпохе e, освобождается, когда эпоха
+ * дошла до e + 2: все потоки, которые могли его видеть, к этому моменту
+ * уже вышли. Одновременно работают до ReaderSlots потоков, остальные
+ * ждут освобождения слота.
+ * @tparam Type - тип хранимых ключей
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, class Compare = std::less<Type>>
+class ConcurrentAVLTree {
+public:
+
+    /**
+     * Конструктор по умолчанию
+     */
+    ConcurrentAVLTree() : root(nullptr), size(0) {}
+
+    ConcurrentAVLTree(const ConcurrentAVLTree&) = delete;
+    ConcurrentAVLTree& operator=(const ConcurrentAVLTree&) = delete;
+
+    /**
+     * Деструктор (одновременных обращений к дереву быть не должно)
+     */
+    ~ConcurrentAVLTree() {
+        destroyTree(root.load(std::memory_order_relaxed));
+        for (const Retired& entry : retired)
+            delete entry.node;
+    }
+
+    /**
+     * Вставка ключа в дерево
+     * @param key - ключ
+     * @return был ли ключ вставлен
+     */
+    bool insert(const Type& key) {
+        {
+            ReadGuard guard(*this);
+
+            while (true) {
+                Position position = locate(key);
+
+                if (position.found != nullptr) {
+                    Node* node = position.found;
+                    std::lock_guard<std::mutex> lock(node->lock);
+
+                    // Узел вырезан после спуска - ищем заново
+                    if (node->version.load(std::memory_order_relaxed) & Unlinked)
+                        continue;
+                    if (node->present.load(std::memory_order_relaxed))
+                        return false;
+
+                    // Маршрутный узел снова получает ключ
+                    node->present.store(true, std::memory_order_release);
+                    size.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                Node* parent = position.parent;
+
+                if (!attach(key, parent, position.version))
+                    continue;
+
+                size.fetch_add(1, std::memory_order_relaxed);
+                retrace(parent);
+                break;
+            }
+        }
+
+        collect();
+        return true;
+    }
+
+    /**
+     * Удаления ключа из дерева
+     * @param key - ключ
+     * @return был ли ключ удалён
+     */
+    bool remove(const Type& key) {
+        {
+            ReadGuard guard(*this);
+
+            while (true) {
+                Node* node = locate(key).found;
+
+                if (node == nullptr)
+                    return false;
+
+                {
+                    std::lock_guard<std::mutex> lock(node->lock);
+
+                    if (node->version.load(std::memory_order_relaxed) & Unlinked)
+                        continue;
+                    if (!node->present.load(std::memory_order_relaxed))
+                        return false;
+
+                    // Ключ исчезает для читателей в этот момент
+                    node->present.store(false, std::memory_order_release);
+                    size.fetch_sub(1, std::memory_order_relaxed);
+                }
+
+                // Узел с не более чем одним потомком вырезается при подъёме,
+                // с двумя потомками - остаётся маршрутным
+                retrace(node);
+                break;
+            }
+        }
+
+        collect();
+        return true;
+    }
+
+    /**
+     * Проверка на существования ключа без блокировок
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Type& key) const {
+        ReadGuard guard(*this);
+        const Node* node = locate(key).found;
+
+        return node != nullptr && node->present.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Поиск ключа без блокировок
+     * (удобен, если компаратор сравнивает только часть ключа)
+     * @param key ключ
+     * @return копия найденного ключа или пустое значение
+     */
+    std::optional<Type> find(const Type& key) const {
+        ReadGuard guard(*this);
+        const Node* node = locate(key).found;
+
+        // Узел не освобождается, пока слот занят
+        if (node == nullptr || !node->present.load(std::memory_order_acquire))
+            return std::nullopt;
+        return node->key;
+    }
+
+    /**
+     * Количество ключей в дереве
+     * @return размер дерева
+     */
+    size_t getSize() const {
+        return size.load(std::memory_order_relaxed);
+    }
+
+private:
+    using Node = ConcurrentNode<Type>;
+
+    /**
+     * Слот потока (на отдельной кэш-линии, чтобы потоки не мешали друг другу)
+     */
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0}; // эпоха входа потока (0 - слот свободен)
+    };
+
+    /**
+     * Вырезанный узел и эпоха, в которой он вырезан
+     */
+    struct Retired {
+        Node* node;
+        uint64_t epoch;
+    };
+
+    /**
+     * Результат спуска: узел с ключом или место для нового узла
+     */
+    struct Position {
+        Node* found;        // узел с ключом (возможно, маршрутный) или nullptr
+        Node* parent;       // узел с пустым потомком на месте ключа (nullptr - пустое дерево)
+        uint64_t version;   // версия parent, при которой потомок оказался пустым
+    };
+
+    /**
+     * Слот, занятый на время жизни объекта
+     */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const ConcurrentAVLTree& tree) : slot(tree.enter()) {}
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        ~ReadGuard() {
+            slot->epoch.store(0, std::memory_order_release);
+        }
+
+    private:
+        ReaderSlot* slot;
+    };
+
+    /** Максимальная высота дерева (маршрутные узлы и ослабленный баланс могут её немного увеличить) */
+    static constexpr size_t MaxHeight = 128;
+    /** Признак сжимающегося узла (идёт поворот, опускающий узел) */
+    static constexpr uint64_t Shrinking = 1;
+    /** Признак вырезанного из дерева узла */
+    static constexpr uint64_t Unlinked = 2;
+    /** Шаг увеличения версии */
+    static constexpr uint64_t VersionStep = 4;
+    /** Количество слотов потоков */
+    static constexpr size_t ReaderSlots = 64;
+    /** Количество вырезанных узлов, после которого писатель пытается их освободить */
+    static constexpr size_t ReclaimBatch = 64;
+
+    /** Узлу ничего не нужно */
+    static constexpr int NothingRequired = -1;
+    /** Маршрутный узел с не более чем одним потомком нужно вырезать */
+    static constexpr int UnlinkRequired = -2;
+    /** Узлу нужен поворот */
+    static constexpr int RebalanceRequired = -3;
+
+    /** Указатель на корень дерева */
+    std::atomic<Node*> root;
+    /** Количество ключей */
+    std::atomic<size_t> size;
+    /** Блокировка указателя на корень (стоит выше блокировок всех узлов) */
+    std::mutex rootLock;
+    /** Текущая эпоха (меняется под reclaimMutex) */
+    std::atomic<uint64_t> epoch{1};
+    /** Слоты потоков */
+    mutable ReaderSlot readers[ReaderSlots];
+    /** Мьютекс списка вырезанных узлов */
+    std::mutex reclaimMutex;
+    /** Вырезанные узлы, которые ещё могут читаться (в порядке эпох) */
+    std::vector<Retired> retired;
+    /** Количество вырезанных узлов (для проверки без мьютекса) */
+    std::atomic<size_t> retiredCount{0};
+    /** Компаратор для упорядочивания элемментов */
+    Compare compare;
+
+    static Node* child(const Node* node, bool toLeft) {
+        return (toLeft ? node->left : node->right).load(std::memory_order_acquire);
+    }
+
+    static int height(const Node* node) {
+        return node == nullptr ? 0 : node->height.load(std::memory_order_relaxed);
+    }
+
+    static void update(Node* node) {
+        node->height.store(std::max(height(child(node, true)), height(child(node, false))) + 1,
+                           std::memory_order_relaxed);
+    }
+
+    /**
+     * Что нужно узлу по текущим (возможно, устаревшим) значениям
+     * @param node узел
+     * @return NothingRequired, UnlinkRequired, RebalanceRequired
+     * или новая высота, если нужно исправить только её
+     */
+    static int condition(const Node* node) {
+        Node* left = child(node, true);
+        Node* right = child(node, false);
+
+        if ((left == nullptr || right == nullptr) && !node->present.load(std::memory_order_relaxed))
+            return UnlinkRequired;
+
+        int leftHeight = height(left);
+        int rightHeight = height(right);
+        int balance = leftHeight - rightHeight;
+
+        if (balance > 1 || balance < -1)
+            return RebalanceRequired;
+
+        int required = std::max(leftHeight, rightHeight) + 1;
+        return required != node->height.load(std::memory_order_relaxed) ? required : NothingRequired;
+    }
+
+    /**
+     * Блокировка родителя (nullptr - блокировка указателя на корень)
+     */
+    std::mutex& lockOf(Node* parent) {
+        return parent == nullptr ? rootLock : parent->lock;
+    }
+
+    /**
+     * Подвешивание нового листа под блокировкой родителя
+     * @param key ключ
+     * @param parent родитель нового листа (nullptr для корня)
+     * @param version версия parent, при которой место было пустым
+     * @return удалось ли подвесить (иначе место изменилось, спуск повторяется)
+     */
+    bool attach(const Type& key, Node* parent, uint64_t version) {
+        std::lock_guard<std::mutex> lock(lockOf(parent));
+
+        if (parent == nullptr) {
+            if (root.load(std::memory_order_relaxed) != nullptr)
+                return false;
+
+            root.store(new Node(key, nullptr), std::memory_order_release);
+            return true;
+        }
+
+        // Неизменная версия гарантирует, что ключ по-прежнему попадает в поддерево parent
+        bool toLeft = compare(key, parent->key);
+        if (parent->version.load(std::memory_order_relaxed) != version || child(parent, toLeft) != nullptr)
+            return false;
+
+        // Публикация полностью инициализированного узла
+        (toLeft ? parent->left : parent->right).store(new Node(key, parent), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Замена потомка parent (или корня) на другой узел
+     * (parent и previous заблокированы)
+     * @param parent родитель (nullptr для корня)
+     * @param previous прежний потомок
+     * @param next новый потомок
+     */
+    void replaceChild(Node* parent, Node* previous, Node* next) {
+        if (next != nullptr)
+            next->parent.store(parent, std::memory_order_release);
+
+        if (parent == nullptr)
+            root.store(next, std::memory_order_release);
+        else if (child(parent, true) == previous)
+            parent->left.store(next, std::memory_order_release);
+        else
+            parent->right.store(next, std::memory_order_release);
+    }
+
+    /**
+     * Вырезание узла, у которого не более одного потомка
+     * (parent и node заблокированы)
+     * @param parent родитель (nullptr для корня)
+     * @param node узел
+     */
+    void unlink(Node* parent, Node* node) {
+        Node* next = child(node, true) != nullptr ? child(node, true) : child(node, false);
+
+        replaceChild(parent, node, next);
+
+        // Потоки, стоящие на этом узле, вернутся на уровень выше
+        node->version.store(node->version.load(std::memory_order_relaxed) | Unlinked, std::memory_order_release);
+
+        // Эпоха читается после вырезания: потоки, видевшие узел, вошли не позже неё
+        std::lock_guard<std::mutex> lock(reclaimMutex);
+        retired.push_back(Retired{node, epoch.load(std::memory_order_seq_cst)});
+        retiredCount.store(retired.size(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Спуск к ключу (вызывающий занимает слот)
+     * @param key ключ
+     * @return узел с ключом или место, где он должен быть
+     */
+    Position locate(const Type& key) const {
+        Node* path[MaxHeight];        // Пройденные узлы
+        uint64_t versions[MaxHeight]; // Версии, при которых узлы были пройдены
+        size_t depth = 0;
+
+        while (true) {
+            Node* node = nullptr;
+            uint64_t version = 0;
+            bool toLeft = false;
+            Node* next;
+
+            // Чтение потомка текущего узла (depth == 0 - указатель на корень)
+            if (depth == 0) {
+                next = root.load(std::memory_order_acquire);
+            } else {
+                node = path[depth - 1];
+                version = versions[depth - 1];
+                toLeft = compare(key, node->key);
+                next = (toLeft ? node->left : node->right).load(std::memory_order_acquire);
+
+                // Узел изменился - возвращаемся на уровень выше
+                if (node->version.load(std::memory_order_acquire) != version) {
+                    depth--;
+                    continue;
+                }
+            }
+
+            if (next == nullptr)
+                return Position{nullptr, node, version};
+
+            if (!compare(key, next->key) && !compare(next->key, key))
+                return Position{next, node, version};
+
+            uint64_t nextVersion = next->version.load(std::memory_order_acquire);
+
+            // Потомок поворачивается - ждём и читаем заново
+            if (nextVersion & Shrinking) {
+                while (next->version.load(std::memory_order_acquire) == nextVersion)
+                    std::this_thread::yield();
+                continue;
+            }
+
+            // Потомок вырезан или указатель уже поменялся - читаем заново
+            if (nextVersion & Unlinked)
+                continue;
+
+            if (depth == 0) {
+                if (root.load(std::memory_order_acquire) != next)
+                    continue;
+            } else {
+                if ((toLeft ? node->left : node->right).load(std::memory_order_acquire) != next)
+                    continue;
+                if (node->version.load(std::memory_order_acquire) != version) {
+                    depth--;
+                    continue;
+                }
+            }
+
+            path[depth] = next;
+            versions[depth] = nextVersion;
+            depth++;
+        }
+    }
+
+    /**
+     * Вход потока: занятие свободного слота и запись в него текущей эпохи
+     * @return занятый слот
+     */
+    ReaderSlot* enter() const {
+        size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % ReaderSlots;
+
+        while (true) {
+            uint64_t current = epoch.load(std::memory_order_seq_cst);
+
+            for (size_t i = 0; i < ReaderSlots; ++i) {
+                ReaderSlot& slot = readers[(start + i) % ReaderSlots];
+                uint64_t expected = 0;
+
+                if (slot.epoch.load(std::memory_order_relaxed) != 0 ||
+                    !slot.epoch.compare_exchange_strong(expected, current, std::memory_order_seq_cst))
+                    continue;
+
+                // Эпоха могла смениться до записи в слот: писатель мог не увидеть
+                // поток, поэтому в слоте должна оказаться эпоха, прочитанная после записи
+                uint64_t actual = epoch.load(std::memory_order_seq_cst);
+
+                while (actual != current) {
+                    current = actual;
+                    slot.epoch.store(current, std::memory_order_seq_cst);
+                    actual = epoch.load(std::memory_order_seq_cst);
+                }
+
+                return &slot;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Переход к следующей эпохе, если все потоки в текущей,
+     * и освобождение узлов, вырезанных две эпохи назад и ранее
+     * (вызывается писателем после выхода из слота, пока другой
+     * писатель освобождает узлы, остальные его не ждут)
+     */
+    void collect() {
+        if (retiredCount.load(std::memory_order_relaxed) < ReclaimBatch)
+            return;
+
+        std::vector<Node*> freed;
+        {
+            std::unique_lock<std::mutex> lock(reclaimMutex, std::try_to_lock);
+            if (!lock.owns_lock())
+                return;
+
+            uint64_t current = epoch.load(std::memory_order_relaxed);
+            bool quiet = true;
+
+            for (const ReaderSlot& slot : readers) {
+                uint64_t entered = slot.epoch.load(std::memory_order_seq_cst);
+
+                if (entered != 0 && entered != current) {
+                    quiet = false;
+                    break;
+                }
+            }
+
+            if (quiet)
+                epoch.store(++current, std::memory_order_seq_cst);
+
+            while (freed.size() < retired.size() && retired[freed.size()].epoch + 2 <= current)
+                freed.push_back(retired[freed.size()].node);
+            retired.erase(retired.begin(), retired.begin() + freed.size());
+            retiredCount.store(retired.size(), std::memory_order_relaxed);
+        }
+
+        // Освобождение без мьютекса: вырезающие узлы писатели его не ждут
+        for (Node* node : freed)
+            delete node;
+    }
+
+    /**
+     * Малый правый поворот: node опускается, его левый потомок поднимается
+     * (родитель node, node и левый потомок заблокированы)
+     * @param node узел у которого выполняем поворот
+     * @return новая вершина поддерева
+     */
+    Node* rightRotate(Node* node) {
+        Node* parent = node->parent.load(std::memory_order_acquire);
+        Node* result = child(node, true);
+        Node* tmp = child(result, false);
+        uint64_t version = node->version.load(std::memory_order_relaxed);
+
+        node->version.store(version | Shrinking, std::memory_order_seq_cst);
+
+        node->left.store(tmp, std::memory_order_release);
+        if (tmp != nullptr)
+            tmp->parent.store(node, std::memory_order_release);
+        result->right.store(node, std::memory_order_release);
+        node->parent.store(result, std::memory_order_release);
+        replaceChild(parent, node, result);
+
+        update(node);
+        update(result);
+
+        node->version.store(version + VersionStep, std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * Малый левый поворот: node опускается, его правый потомок поднимается
+     * (родитель node, node и правый потомок заблокированы)
+     * @param node узел у которого выполняем поворот
+     * @return новая вершина поддерева
+     */
+    Node* leftRotate(Node* node) {
+        Node* parent = node->parent.load(std::memory_order_acquire);
+        Node* result = child(node, false);
+        Node* tmp = child(result, true);
+        uint64_t version = node->version.load(std::memory_order_relaxed);
+
+        node->version.store(version | Shrinking, std::memory_order_seq_cst);
+
+        node->right.store(tmp, std::memory_order_release);
+        if (tmp != nullptr)
+            tmp->parent.store(node, std::memory_order_release);
+        result->left.store(node, std::memory_order_release);
+        node->parent.store(result, std::memory_order_release);
+        replaceChild(parent, node, result);
+
+        update(node);
+        update(result);
+
+        node->version.store(version + VersionStep, std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * Исправление высоты заблокированного узла
+     * @param node узел (nullptr - указатель на корень, исправлять нечего)
+     * @return следующий узел для исправления или nullptr
+     */
+    static Node* fixHeight(Node* node) {
+        if (node == nullptr)
+            return nullptr;
+
+        int required = condition(node);
+
+        if (required == NothingRequired)
+            return nullptr;
+        if (required == UnlinkRequired || required == RebalanceRequired)
+            return node;
+
+        node->height.store(required, std::memory_order_relaxed);
+        return node->parent.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Вырезание маршрутного узла или поворот
+     * (parent и node заблокированы, потомки блокируются попыткой сверху вниз)
+     * @param parent родитель (nullptr для корня)
+     * @param node узел
+     * @return следующий узел для исправления, node - если потомок занят, или nullptr
+     */
+    Node* rebalance(Node* parent, Node* node) {
+        Node* left = child(node, true);
+        Node* right = child(node, false);
+
+        if ((left == nullptr || right == nullptr) && !node->present.load(std::memory_order_relaxed)) {
+            unlink(parent, node);
+            return parent;
+        }
+
+        int balance = height(left) - height(right);
+        bool toLeft = balance > 1;
+
+        if (balance >= -1 && balance <= 1)
+            return fixHeight(node);
+
+        // Поднимаемый потомок, при большом повороте - и его внутренний потомок
+        Node* heavy = toLeft ? left : right;
+        std::unique_lock<std::mutex> heavyLock(heavy->lock, std::try_to_lock);
+        if (!heavyLock.owns_lock())
+            return node;
+
+        Node* inner = child(heavy, !toLeft);
+        Node* top;
+
+        if (height(inner) > height(child(heavy, toLeft))) {
+            std::unique_lock<std::mutex> innerLock(inner->lock, std::try_to_lock);
+            if (!innerLock.owns_lock())
+                return node;
+
+            toLeft ? leftRotate(heavy) : rightRotate(heavy);
+            top = toLeft ? rightRotate(node) : leftRotate(node);
+        } else {
+            top = toLeft ? rightRotate(node) : leftRotate(node);
+        }
+
+        // Высоты потомков могли измениться во время поворота
+        if (condition(node) != NothingRequired)
+            return node;
+        if (condition(top) != NothingRequired)
+            return top;
+        return fixHeight(parent);
+    }
+
+    /**
+     * Восстановление баланса от узла к корню
+     * Попутно вырезаются маршрутные узлы, у которых остался не более
+     * чем один потомок, подъём прекращается, когда узлу ничего не нужно
+     * @param node нижний изменившийся узел
+     */
+    void retrace(Node* node) {
+        while (node != nullptr) {
+            int required = condition(node);
+
+            if (required == NothingRequired || (node->version.load(std::memory_order_acquire) & Unlinked))
+                return;
+
+            // Только высота: достаточно блокировки самого узла
+            if (required > 0) {
+                std::lock_guard<std::mutex> lock(node->lock);
+
+                node = node->version.load(std::memory_order_relaxed) & Unlinked ? nullptr : fixHeight(node);
+                continue;
+            }
+
+            Node* next = node;
+            {
+                Node* parent = node->parent.load(std::memory_order_acquire);
+                std::lock_guard<std::mutex> parentLock(lockOf(parent));
+
+                // Родитель сменился или вырезан - повторяем с новым родителем
+                if ((parent != nullptr && (parent->version.load(std::memory_order_relaxed) & Unlinked)) ||
+                    node->parent.load(std::memory_order_acquire) != parent)
+                    continue;
+
+                std::unique_lock<std::mutex> lock(node->lock, std::try_to_lock);
+
+                // Вырезавший узел поток сам продолжает подъём
+                if (lock.owns_lock())
+                    next = node->version.load(std::memory_order_relaxed) & Unlinked ? nullptr : rebalance(parent, node);
+            }
+
+            // Узел или потомок заняты - уступаем их владельцу и повторяем
+            if (next == node)
+                std::this_thread::yield();
+            node = next;
+        }
+    }
+
+    void destroyTree(Node* node) {
+        if (node == nullptr)
+            return;
+
+        destroyTree(child(node, true));
+        destroyTree(child(node, false));
+        delete node;
+    }
+};
+
+#endif //AVLTREE_CONCURRENTAVLTREE_H
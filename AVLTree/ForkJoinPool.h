@@ -0,0 +1,167 @@
+#ifndef AVLTREE_FORKJOINPOOL_H
+#define AVLTREE_FORKJOINPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Пул потоков для рекурсивного параллелизма вида fork-join
+ * Поток, ожидающий завершения своей подзадачи, не блокируется,
+ * а выполняет задачи из общей очереди, поэтому вложенные
+ * вызовы invoke не приводят к взаимной блокировке.
+ */
+class ForkJoinPool {
+public:
+
+    /**
+     * Конструктор
+     * @param threads количество рабочих потоков
+     * (вызывающий поток тоже участвует в вычислениях)
+     */
+    explicit ForkJoinPool(size_t threads) {
+        stop = false;
+
+        for (size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    /**
+     * Деструктор, дожидается завершения рабочих потоков
+     */
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    /**
+     * Общий пул на все ядра процессора
+     */
+    static ForkJoinPool& common() {
+        static ForkJoinPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    /**
+     * Параллельное выполнение двух функций
+     * left может быть выполнена другим потоком, right выполняется
+     * в текущем, возврат происходит после завершения обеих
+     * @param left первая функция
+     * @param right вторая функция
+     */
+    template <class Left, class Right>
+    void invoke(Left&& left, Right&& right) {
+        Task task(&call<typename std::remove_reference<Left>::type>, &left);
+
+        push(&task);
+        right();
+
+        // Пока первая функция не выполнена, помогаем выполнять задачи из очереди
+        while (!task.done.load(std::memory_order_acquire)) {
+            Task* other = tryPop();
+
+            if (other != nullptr)
+                execute(other);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    /**
+     * Задача: функция без выделения памяти под её копию
+     */
+    struct Task {
+        /** Вызов функции по указателю на неё */
+        void (*run)(void*);
+        /** Указатель на функцию */
+        void* context;
+        /** Выполнена ли задача */
+        std::atomic<bool> done;
+
+        Task(void (*run)(void*), void* context) : run(run), context(context), done(false) {}
+    };
+
+    /** Рабочие потоки */
+    std::vector<std::thread> workers;
+    /** Очередь задач */
+    std::deque<Task*> queue;
+    /** Мьютекс очереди */
+    std::mutex mutex;
+    /** Оповещение о новых задачах */
+    std::condition_variable condition;
+    /** Признак завершения работы пула */
+    bool stop;
+
+    template <class Function>
+    static void call(void* function) {
+        (*static_cast<Function*>(function))();
+    }
+
+    static void execute(Task* task) {
+        task->run(task->context);
+        task->done.store(true, std::memory_order_release);
+    }
+
+    void push(Task* task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(task);
+        }
+        condition.notify_one();
+    }
+
+    /**
+     * Извлечение последней добавленной задачи (она ближе всего
+     * к текущему вычислению) без ожидания
+     * @return задача или nullptr
+     */
+    Task* tryPop() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (queue.empty())
+            return nullptr;
+
+        Task* task = queue.back();
+        queue.pop_back();
+        return task;
+    }
+
+    /**
+     * Цикл рабочего потока: берёт самые старые (самые крупные) задачи
+     */
+    void work() {
+        while (true) {
+            Task* task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return stop || !queue.empty(); });
+
+                if (queue.empty())
+                    return;
+
+                task = queue.front();
+                queue.pop_front();
+            }
+
+            execute(task);
+        }
+    }
+};
+
+#endif //AVLTREE_FORKJOINPOOL_H
@@ -0,0 +1,269 @@
+#ifndef AVLTREE_FROZENAVLTREE_H
+#define AVLTREE_FROZENAVLTREE_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+/**
+ * Неизменяемый снимок упорядоченного множества для частых поисков
+ * Ключи хранятся в массиве в порядке Эйтцингера (обход дерева в ширину:
+ * потомки элемента i находятся в 2i + 1 и 2i + 2), поэтому первые
+ * уровни поиска лежат в нескольких строках кэша, спуск не содержит
+ * условных переходов, а следующие уровни заранее подгружаются в кэш.
+ * @tparam Type - тип хранимых ключей
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, class Compare = std::less<Type>>
+class FrozenAVLTree {
+public:
+
+    /**
+     * Итератор по ключам в порядке возрастания
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        Iterator() : tree(nullptr), index(0) {}
+
+        reference operator*() const {
+            return tree->keys[index];
+        }
+
+        pointer operator->() const {
+            return &tree->keys[index];
+        }
+
+        Iterator& operator++() {
+            index = tree->next(index);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return index == rhs.index;
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return index != rhs.index;
+        }
+
+    private:
+        friend class FrozenAVLTree;
+
+        /** Снимок */
+        const FrozenAVLTree* tree;
+        /** Позиция в массиве (размер массива для end()) */
+        size_t index;
+
+        Iterator(const FrozenAVLTree* tree, size_t index) : tree(tree), index(index) {}
+    };
+
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
+    /**
+     * Конструктор по умолчанию (пустой снимок)
+     */
+    FrozenAVLTree() = default;
+
+    /**
+     * Построение снимка из упорядоченной последовательности различных ключей за O(n)
+     * @param first начало последовательности
+     * @param last конец последовательности
+     * @param count количество ключей
+     */
+    template <class InputIterator>
+    FrozenAVLTree(InputIterator first, InputIterator last, size_t count) {
+        if (count == 0)
+            return;
+
+        keys.assign(count, *first);
+        fill(first, last, 0);
+    }
+
+    /**
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Type& key) const {
+        size_t index = lowerBoundIndex(key);
+        return index != keys.size() && !compare(key, keys[index]);
+    }
+
+    /**
+     * Поиск ключа
+     * @param key ключ
+     * @return итератор на ключ или end()
+     */
+    iterator find(const Type& key) const {
+        size_t index = lowerBoundIndex(key);
+
+        if (index != keys.size() && compare(key, keys[index]))
+            index = keys.size();
+        return iterator(this, index);
+    }
+
+    /**
+     * Первый ключ, не меньший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator lower_bound(const Type& key) const {
+        return iterator(this, lowerBoundIndex(key));
+    }
+
+    /**
+     * Первый ключ, больший заданного
+     * @param key ключ
+     * @return итератор на найденный ключ или end()
+     */
+    iterator upper_bound(const Type& key) const {
+        size_t index = 0;
+
+        while (index < keys.size()) {
+            prefetch(index);
+            index = 2 * index + 1 + !compare(key, keys[index]);
+        }
+
+        return iterator(this, recover(index));
+    }
+
+    /**
+     * Итератор на наименьший ключ
+     */
+    iterator begin() const {
+        size_t index = 0;
+
+        if (keys.empty())
+            return end();
+
+        while (2 * index + 1 < keys.size())
+            index = 2 * index + 1;
+
+        return iterator(this, index);
+    }
+
+    /**
+     * Итератор за наибольшим ключом
+     */
+    iterator end() const {
+        return iterator(this, keys.size());
+    }
+
+    /**
+     * Количество ключей в снимке
+     * @return размер
+     */
+    size_t getSize() const {
+        return keys.size();
+    }
+
+private:
+    /** Количество ключей в одной строке кэша (степень двойки) */
+    static constexpr size_t KeysPerLine = sizeof(Type) <= 4 ? 16 : sizeof(Type) <= 8 ? 8 :
+                                          sizeof(Type) <= 16 ? 4 : sizeof(Type) <= 32 ? 2 : 1;
+
+    /** Ключи в порядке Эйтцингера */
+    std::vector<Type> keys;
+    /** Компаратор для упорядочивания элемментов */
+    Compare compare;
+
+    /**
+     * Рекурсивное заполнение массива при симметричном обходе
+     * @param it текущая позиция в последовательности (сдвигается)
+     * @param last конец последовательности
+     * @param index позиция в массиве
+     */
+    template <class InputIterator>
+    void fill(InputIterator& it, InputIterator last, size_t index) {
+        if (index >= keys.size() || it == last)
+            return;
+
+        fill(it, last, 2 * index + 1);
+        keys[index] = *it;
+        ++it;
+        fill(it, last, 2 * index + 2);
+    }
+
+    /**
+     * Подгрузка в кэш потомков через несколько уровней
+     * (потомки элемента i на глубине k лежат подряд, начиная с (i + 1) * 2^k - 1)
+     * @param index позиция в массиве
+     */
+    void prefetch(size_t index) const {
+#if defined(__GNUC__)
+        size_t target = (index + 1) * KeysPerLine - 1;
+
+        if (target < keys.size())
+            __builtin_prefetch(&keys[target]);
+#endif
+    }
+
+    /**
+     * Первая позиция, ключ в которой не меньше заданного
+     * @param key ключ
+     * @return позиция или размер массива
+     */
+    size_t lowerBoundIndex(const Type& key) const {
+        size_t index = 0;
+
+        // Спуск без ветвлений: направление добавляется к индексу
+        while (index < keys.size()) {
+            prefetch(index);
+            index = 2 * index + 1 + compare(keys[index], key);
+        }
+
+        return recover(index);
+    }
+
+    /**
+     * Восстановление ответа после спуска за пределы массива:
+     * ответ - последний узел, из которого спуск шёл влево
+     * @param index позиция за пределами массива (или позиция, от которой
+     * ищется ближайший предок, в чьё левое поддерево она входит)
+     * @return позиция ответа или размер массива
+     */
+    size_t recover(size_t index) const {
+        size_t position = index + 1; // Нумерация с единицы
+
+        // Отбрасываем повороты направо и последний поворот налево
+        while (position & 1)
+            position >>= 1;
+        position >>= 1;
+
+        return position == 0 ? keys.size() : position - 1;
+    }
+
+    /**
+     * Следующая по возрастанию позиция
+     * @param index позиция
+     * @return позиция или размер массива
+     */
+    size_t next(size_t index) const {
+        if (2 * index + 2 < keys.size()) {
+            // Самый левый элемент правого поддерева
+            index = 2 * index + 2;
+            while (2 * index + 1 < keys.size())
+                index = 2 * index + 1;
+            return index;
+        }
+
+        // Поднимаемся, пока приходим из правого поддерева
+        return recover(index);
+    }
+};
+
+#endif //AVLTREE_FROZENAVLTREE_H
@@ -0,0 +1,180 @@
+#ifndef AVLTREE_INTERVALTREE_H
+#define AVLTREE_INTERVALTREE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include "AVLTree.h"
+
+/**
+ * Отрезок [low, high] с наибольшим концом отрезков своего поддерева
+ * (наибольший конец изменяет только дерево)
+ * @tparam Key - тип концов
+ */
+template <class Key>
+struct Interval {
+    Key low;  // начало
+    Key high; // конец (включительно)
+
+    Interval(const Key& low, const Key& high) : low(low), high(high), max(high) {}
+
+private:
+    friend struct NodeAugmentation<Interval<Key>>;
+    friend class IntervalTree<Key>;
+
+    Key max;  // наибольший конец в поддереве
+};
+
+/**
+ * Порядок отрезков: по началу, затем по концу
+ */
+template <class Key>
+struct IntervalCompare {
+    bool operator()(const Interval<Key>& lhs, const Interval<Key>& rhs) const {
+        return lhs.low < rhs.low || (!(rhs.low < lhs.low) && lhs.high < rhs.high);
+    }
+};
+
+/**
+ * Наибольший конец пересчитывается по потомкам вместе с высотой,
+ * в том числе при поворотах
+ */
+template <class Key>
+struct NodeAugmentation<Interval<Key>> {
+    static constexpr bool enabled = true;
+
+    static void update(Node<Interval<Key>>* node) {
+        const Key* max = &node->key.high;
+
+        if (node->left != nullptr && *max < node->left->key.max)
+            max = &node->left->key.max;
+        if (node->right != nullptr && *max < node->right->key.max)
+            max = &node->right->key.max;
+
+        node->key.max = *max;
+    }
+};
+
+/**
+ * Дерево интервалов на AVL дереве
+ * Отрезки упорядочены по началу, в каждом узле хранится наибольший конец
+ * в поддереве, поэтому поиск пересекающихся отрезков пропускает поддеревья,
+ * целиком лежащие левее запроса, и всё, что начинается правее него.
+ * Одинаковые отрезки хранятся один раз.
+ * @tparam Key - тип концов (сравнивается оператором <)
+ */
+template <class Key>
+class IntervalTree {
+public:
+    using iterator = typename AVLTree<Interval<Key>, IntervalCompare<Key>>::iterator;
+
+    /**
+     * Вставка отрезка [low, high]
+     * @return был ли отрезок вставлен
+     * @throws std::invalid_argument если high < low
+     */
+    bool insert(const Key& low, const Key& high) {
+        if (high < low)
+            throw std::invalid_argument("IntervalTree: interval end is less than its start");
+
+        return tree.insert(Interval<Key>(low, high)).second;
+    }
+
+    /**
+     * Удаление отрезка [low, high]
+     * @return был ли отрезок удалён
+     */
+    bool remove(const Key& low, const Key& high) {
+        return tree.remove(Interval<Key>(low, high));
+    }
+
+    /**
+     * Обход всех отрезков, пересекающихся с [a, b], в порядке возрастания начала
+     * за O(min(n, (k + 1) * Lg(n))), где k - количество найденных отрезков.
+     * Оценка O(Lg(n) + k) не достигается: найденные отрезки могут лежать
+     * в разных поддеревьях, и до каждого ведёт свой спуск длиной до Lg(n)
+     * @param a начало запроса
+     * @param b конец запроса
+     * @param visitor функция, вызываемая для каждого отрезка
+     */
+    template <class Visitor>
+    void overlaps(const Key& a, const Key& b, Visitor visitor) const {
+        overlapsNode(tree.head, a, b, visitor);
+    }
+
+    /**
+     * Есть ли отрезок, пересекающийся с [a, b], за O(Lg(n))
+     * @param a начало запроса
+     * @param b конец запроса
+     * @return результат проверки
+     */
+    bool intersects(const Key& a, const Key& b) const {
+        const Node<Interval<Key>>* node = tree.head;
+
+        while (node != nullptr) {
+            if (!(b < node->key.low) && !(node->key.high < a))
+                return true;
+
+            // Если слева есть конец не меньше a, то пересечение
+            // может быть только там: все начала справа больше b
+            if (node->left != nullptr && !(node->left->key.max < a))
+                node = node->left;
+            else
+                node = node->right;
+        }
+
+        return false;
+    }
+
+    /**
+     * Итератор на отрезок с наименьшим началом
+     */
+    iterator begin() const {
+        return tree.begin();
+    }
+
+    /**
+     * Итератор за последним отрезком
+     */
+    iterator end() const {
+        return tree.end();
+    }
+
+    /**
+     * Удаление всех отрезков
+     */
+    void clear() {
+        tree.clear();
+    }
+
+    /**
+     * Количество отрезков
+     * @return размер дерева
+     */
+    size_t getSize() const {
+        return tree.getSize();
+    }
+
+private:
+    /** Дерево отрезков, упорядоченных по началу */
+    AVLTree<Interval<Key>, IntervalCompare<Key>> tree;
+
+    template <class Visitor>
+    static void overlapsNode(const Node<Interval<Key>>* node, const Key& a, const Key& b, Visitor& visitor) {
+        // Все концы поддерева левее запроса
+        if (node == nullptr || node->key.max < a)
+            return;
+
+        overlapsNode(node->left, a, b, visitor);
+
+        // Этот и все правые отрезки начинаются правее запроса
+        if (b < node->key.low)
+            return;
+
+        if (!(node->key.high < a))
+            visitor(node->key);
+
+        overlapsNode(node->right, a, b, visitor);
+    }
+};
+
+#endif //AVLTREE_INTERVALTREE_H
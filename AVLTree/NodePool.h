@@ -0,0 +1,208 @@
+#ifndef AVLTREE_NODEPOOL_H
+#define AVLTREE_NODEPOOL_H
+
+#include <cstddef>
+#include <new>
+#include <memory>
+
+/**
+ * Пул узлов (арена)
+ * Выдаёт память под узлы из непрерывных блоков, освобождённые узлы
+ * складываются в список свободных и переиспользуются.
+ * Вся память пула освобождается за один вызов release().
+ * Пул выдаёт неинициализированную память: конструирование
+ * и разрушение объектов выполняет контейнер.
+ * Копии пула разделяют одну арену (память освобождается вместе
+ * с последней копией), поэтому деревья с общим пулом могут
+ * передавать друг другу узлы. Арена не потокобезопасна.
+ * @tparam NodeType - тип узла
+ * @tparam BlockSize - количество узлов в одном блоке
+ */
+template <class NodeType, size_t BlockSize = 1024>
+class NodePool {
+public:
+    /** Пул умеет освобождать все узлы за один шаг */
+    static constexpr bool bulkRelease = true;
+
+    /**
+     * Конструктор по умолчанию (создаёт новую арену)
+     */
+    NodePool() : arena(std::make_shared<Arena>()) {}
+
+    /**
+     * Выделение памяти под один узел
+     * @return указатель на неинициализированную память
+     */
+    NodeType* allocate() {
+        return arena->allocate();
+    }
+
+    /**
+     * Резервирование непрерывного участка памяти: следующие count
+     * выделений из пустого списка свободных идут подряд из одного блока
+     * @param count количество узлов
+     */
+    void reserve(size_t count) {
+        arena->reserve(count);
+    }
+
+    /**
+     * Возврат узла в пул (объект уже должен быть разрушен)
+     * @param node узел
+     */
+    void deallocate(NodeType* node) {
+        arena->deallocate(node);
+    }
+
+    /**
+     * Освобождение всей памяти арены за один шаг
+     * (все выданные узлы становятся недействительными,
+     * допустимо только для единственного владельца арены)
+     */
+    void release() {
+        arena->release();
+    }
+
+    /**
+     * Является ли пул единственным владельцем арены
+     */
+    bool unique() const {
+        return arena.use_count() == 1;
+    }
+
+    bool operator==(const NodePool& rhs) const {
+        return arena == rhs.arena;
+    }
+
+    bool operator!=(const NodePool& rhs) const {
+        return arena != rhs.arena;
+    }
+
+private:
+    /**
+     * Арена: список блоков и список свободных ячеек
+     */
+    class Arena {
+    public:
+        Arena() {
+            blocks = nullptr;
+            freeList = nullptr;
+            cursor = nullptr;
+            end = nullptr;
+        }
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() {
+            release();
+        }
+
+        NodeType* allocate() {
+            // В первую очередь переиспользуем освобождённые узлы
+            if (freeList != nullptr) {
+                Slot* slot = freeList;
+                freeList = slot->next;
+                return reinterpret_cast<NodeType*>(slot);
+            }
+
+            if (cursor == end)
+                grow(BlockSize);
+
+            return reinterpret_cast<NodeType*>(cursor++);
+        }
+
+        void reserve(size_t count) {
+            if (static_cast<size_t>(end - cursor) < count)
+                grow(count);
+        }
+
+        void deallocate(NodeType* node) {
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->next = freeList;
+            freeList = slot;
+        }
+
+        void release() {
+            while (blocks != nullptr) {
+                Slot* next = blocks->next;
+                delete[] blocks;
+                blocks = next;
+            }
+
+            freeList = nullptr;
+            cursor = nullptr;
+            end = nullptr;
+        }
+
+    private:
+        /** Ячейка блока: либо память под узел, либо звено списка свободных */
+        union Slot {
+            Slot* next;
+            alignas(NodeType) unsigned char storage[sizeof(NodeType)];
+        };
+
+        /** Список блоков (первая ячейка блока хранит указатель на следующий блок) */
+        Slot* blocks;
+        /** Список свободных ячеек */
+        Slot* freeList;
+        /** Первая ещё не выданная ячейка текущего блока */
+        Slot* cursor;
+        /** Конец текущего блока */
+        Slot* end;
+
+        /**
+         * Выделение нового блока
+         * @param count количество узлов в блоке
+         */
+        void grow(size_t count) {
+            Slot* block = new Slot[count + 1];
+
+            block->next = blocks;
+            blocks = block;
+            cursor = block + 1;
+            end = block + 1 + count;
+        }
+    };
+
+    /** Разделяемая арена */
+    std::shared_ptr<Arena> arena;
+};
+
+/**
+ * Распределитель, выделяющий каждый узел отдельным вызовом new
+ * (поведение до появления пула, оставлен для сравнения)
+ * @tparam NodeType - тип узла
+ */
+template <class NodeType>
+class NodeAllocator {
+public:
+    /** Узлы освобождаются только по одному */
+    static constexpr bool bulkRelease = false;
+
+    NodeType* allocate() {
+        return static_cast<NodeType*>(::operator new(sizeof(NodeType)));
+    }
+
+    void deallocate(NodeType* node) {
+        ::operator delete(node);
+    }
+
+    void reserve(size_t) {}
+
+    void release() {}
+
+    bool unique() const {
+        return true;
+    }
+
+    bool operator==(const NodeAllocator&) const {
+        return true;
+    }
+
+    bool operator!=(const NodeAllocator&) const {
+        return false;
+    }
+};
+
+#endif //AVLTREE_NODEPOOL_H
@@ -0,0 +1,614 @@
+#ifndef AVLTREE_PERSISTENTAVLTREE_H
+#define AVLTREE_PERSISTENTAVLTREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+/**
+ * Узел персистентного дерева
+ * Узел может принадлежать нескольким версиям дерева одновременно,
+ * поэтому хранит счётчик ссылок и не имеет указателя на родителя.
+ * @tparam Type - тип хранимого ключа
+ */
+template <class Type>
+struct PersistentNode {
+    Type key;                  // ключ
+    PersistentNode* left;      // указатель на левое поддерево
+    PersistentNode* right;     // указатель на правое поддерево
+    int height;                // высота дерева от данного узла
+    size_t size;               // количество узлов в поддереве
+    std::atomic<size_t> refs;  // количество ссылок на узел
+
+    PersistentNode(const Type& key, PersistentNode* left, PersistentNode* right, int height, size_t size)
+        : key(key), left(left), right(right), height(height), size(size), refs(1) {}
+};
+
+/**
+ * Персистентное AVL дерево
+ * Вставка и удаление копируют только путь от корня до изменяемого узла
+ * (O(Lg(n)) узлов), остальные узлы разделяются между версиями. Путь
+ * копируется за тот же спуск, если ключ действительно вставлен или удалён.
+ * Копирование дерева (snapshot) - O(1): копируется указатель на корень.
+ * Версии можно читать и изменять из разных потоков, каждую версию -
+ * из одного потока одновременно; узлы освобождаются по счётчику ссылок.
+ * Если версия единственная, узлы изменяются на месте без копирования.
+ * @tparam Type - тип хранимых ключей
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, class Compare = std::less<Type>>
+class PersistentAVLTree {
+    using Node = PersistentNode<Type>;
+
+    /** Максимальная высота дерева (AVL дерево из 2^64 узлов ниже 93 уровней) */
+    static constexpr size_t MaxHeight = 96;
+
+public:
+
+    /**
+     * Прямой итератор по ключам версии в порядке возрастания
+     * Узлы не знают родителя, поэтому итератор хранит стек узлов,
+     * от которых спуск шёл влево (вершина стека - текущий узел).
+     * Действителен, пока версия не изменяется (снимки на него не влияют).
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        Iterator() : depth(0) {}
+
+        reference operator*() const {
+            return path[depth - 1]->key;
+        }
+
+        pointer operator->() const {
+            return &path[depth - 1]->key;
+        }
+
+        Iterator& operator++() {
+            const Node* node = path[--depth]->right;
+
+            pushLeft(node);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return current() == rhs.current();
+        }
+
+        bool operator!=(const Iterator& rhs) const {
+            return current() != rhs.current();
+        }
+
+    private:
+        friend class PersistentAVLTree;
+
+        /** Узлы, ключи которых ещё не пройдены */
+        const Node* path[MaxHeight];
+        /** Количество узлов в стеке (0 - итератор за последним ключом) */
+        size_t depth;
+
+        const Node* current() const {
+            return depth == 0 ? nullptr : path[depth - 1];
+        }
+
+        /**
+         * Спуск по левым потомкам с запоминанием пути
+         * @param node вершина поддерева
+         */
+        void pushLeft(const Node* node) {
+            for (; node != nullptr; node = node->left)
+                path[depth++] = node;
+        }
+    };
+
+    using iterator = Iterator;
+
+    /**
+     * Конструктор по умолчанию
+     */
+    PersistentAVLTree() {
+        head = nullptr;
+    }
+
+    /**
+     * Копирование версии за O(1)
+     * @param other версия
+     */
+    PersistentAVLTree(const PersistentAVLTree& other) : compare(other.compare) {
+        head = retain(other.head);
+    }
+
+    PersistentAVLTree(PersistentAVLTree&& other) noexcept : compare(other.compare) {
+        head = other.head;
+        other.head = nullptr;
+    }
+
+    PersistentAVLTree& operator=(PersistentAVLTree other) {
+        std::swap(head, other.head);
+        std::swap(compare, other.compare);
+        return *this;
+    }
+
+    /**
+     * Деструктор
+     */
+    ~PersistentAVLTree() {
+        release(head);
+    }
+
+    /**
+     * Снимок текущей версии за O(1)
+     * Последующие изменения дерева не видны в снимке и наоборот
+     * @return снимок
+     */
+    PersistentAVLTree snapshot() const {
+        return *this;
+    }
+
+    /**
+     * Вставка ключа в дерево за один спуск
+     * (если ключ уже есть, версия не меняется и путь не копируется)
+     * @param key - ключ
+     * @return был ли ключ вставлен
+     */
+    bool insert(const Type& key) {
+        bool unique = isUnique(head, true);
+        bool inserted = false;
+        Node* result = insertNode(head, key, unique, inserted);
+
+        if (inserted)
+            relink(head, result, unique);
+        return inserted;
+    }
+
+    /**
+     * Удаления ключа из дерева за один спуск
+     * (если ключа нет, версия не меняется и путь не копируется)
+     * @param key - ключ
+     * @return был ли ключ удалён
+     */
+    bool remove(const Type& key) {
+        bool unique = isUnique(head, true);
+        bool removed = false;
+        Node* result = deleteNode(head, key, unique, removed);
+
+        if (removed)
+            relink(head, result, unique);
+        return removed;
+    }
+
+    /**
+     * Проверка на существования ключа
+     * @param key ключ
+     * @return результат проверки
+     */
+    bool exist(const Type& key) const {
+        const Node* node = head;
+
+        while (node != nullptr) {
+            if (compare(key, node->key))
+                node = node->left;
+            else if (compare(node->key, key))
+                node = node->right;
+            else
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Поиск ключа
+     * @param key ключ
+     * @return итератор на ключ или end()
+     */
+    iterator find(const Type& key) const {
+        iterator it = lower_bound(key);
+
+        if (it != end() && compare(key, *it))
+            return end();
+        return it;
+    }
+
+    /**
+     * Итератор на первый ключ, не меньший key
+     * @param key ключ
+     */
+    iterator lower_bound(const Type& key) const {
+        iterator it;
+
+        for (const Node* node = head; node != nullptr;) {
+            if (compare(node->key, key)) {
+                node = node->right;
+            } else {
+                it.path[it.depth++] = node;
+                node = node->left;
+            }
+        }
+
+        return it;
+    }
+
+    /**
+     * Итератор на первый ключ, больший key
+     * @param key ключ
+     */
+    iterator upper_bound(const Type& key) const {
+        iterator it;
+
+        for (const Node* node = head; node != nullptr;) {
+            if (compare(key, node->key)) {
+                it.path[it.depth++] = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+
+        return it;
+    }
+
+    /**
+     * Итератор на наименьший ключ
+     */
+    iterator begin() const {
+        iterator it;
+
+        it.pushLeft(head);
+        return it;
+    }
+
+    /**
+     * Итератор за наибольшим ключом
+     */
+    iterator end() const {
+        return iterator();
+    }
+
+    /**
+     * Обход ключей из отрезка [lo, hi] в порядке возрастания
+     * @param lo нижняя граница
+     * @param hi верхняя граница
+     * @param visitor функция, вызываемая для каждого ключа
+     */
+    template <class Visitor>
+    void range(const Type& lo, const Type& hi, Visitor visitor) const {
+        rangeNode(head, lo, hi, visitor);
+    }
+
+    /**
+     * Обход всех ключей в порядке возрастания
+     * @param visitor функция, вызываемая для каждого ключа
+     */
+    template <class Visitor>
+    void forEach(Visitor visitor) const {
+        forEachNode(head, visitor);
+    }
+
+    /**
+     * Удаление всех ключей из версии (снимки не меняются)
+     */
+    void clear() {
+        release(head);
+        head = nullptr;
+    }
+
+    /**
+     * Количество ключей в дереве
+     * @return размер дерева
+     */
+    size_t getSize() const {
+        return subtreeSize(head);
+    }
+
+private:
+    /** Указатель на корень версии */
+    Node* head;
+    /** Компаратор для упорядочивания элемментов */
+    Compare compare;
+
+    static Node* retain(Node* node) {
+        if (node != nullptr)
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    /**
+     * Освобождение ссылки на узел, при последней ссылке
+     * узел удаляется вместе со ссылками на потомков
+     * @param node узел
+     */
+    static void release(Node* node) {
+        if (node == nullptr || node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        release(node->left);
+        release(node->right);
+        delete node;
+    }
+
+    /**
+     * Копия узла, разделяющая с ним потомков
+     * @param node узел
+     * @return новый узел с единственной ссылкой
+     */
+    static Node* copy(const Node* node) {
+        return new Node(node->key, retain(node->left), retain(node->right), node->height, node->size);
+    }
+
+    /**
+     * Получение изменяемого узла: единственный владелец изменяет узел на месте,
+     * иначе создаётся копия, а ссылка на разделяемый узел освобождается
+     * @param node узел, ссылкой на который владеет вызывающий
+     * @return узел, который можно изменять
+     */
+    static Node* own(Node* node) {
+        if (node->refs.load(std::memory_order_acquire) == 1)
+            return node;
+
+        Node* result = copy(node);
+        release(node);
+        return result;
+    }
+
+    /**
+     * Принадлежит ли узел только этой версии: на него и на всех
+     * его предков по пути от корня есть ровно одна ссылка
+     * @param node узел
+     * @param parentUnique принадлежит ли только этой версии родитель
+     * @return результат проверки
+     */
+    static bool isUnique(const Node* node, bool parentUnique) {
+        return parentUnique && node != nullptr && node->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    /**
+     * Замена ссылки на изменённое поддерево: поддерево, изменённое на месте,
+     * уже занимает прежнюю ссылку, а ссылка на разделяемое освобождается
+     * @param link ссылка в изменяемом родителе (или на корень)
+     * @param result новая вершина поддерева
+     * @param unique изменялось ли поддерево на месте
+     */
+    static void relink(Node*& link, Node* result, bool unique) {
+        if (!unique)
+            release(link);
+        link = result;
+    }
+
+    static int height(const Node* node) {
+        return node == nullptr ? 0 : node->height;
+    }
+
+    static size_t subtreeSize(const Node* node) {
+        return node == nullptr ? 0 : node->size;
+    }
+
+    static int getBalance(const Node* node) {
+        return node == nullptr ? 0 : height(node->left) - height(node->right);
+    }
+
+    static void update(Node* node) {
+        node->height = std::max(height(node->left), height(node->right)) + 1;
+        node->size = subtreeSize(node->left) + subtreeSize(node->right) + 1;
+    }
+
+    /**
+     * Малый левый поворот (node уже изменяемый)
+     * @param node узел у которого выполняем поворот
+     * @return новая вершина поддерева
+     */
+    static Node* leftRotate(Node* node) {
+        Node* result = own(node->right);
+
+        node->right = result->left;
+        result->left = node;
+        update(node);
+        update(result);
+        return result;
+    }
+
+    /**
+     * Малый правый поворот (node уже изменяемый)
+     * @param node узел у которого выполняем поворот
+     * @return новая вершина поддерева
+     */
+    static Node* rightRotate(Node* node) {
+        Node* result = own(node->left);
+
+        node->left = result->right;
+        result->right = node;
+        update(node);
+        update(result);
+        return result;
+    }
+
+    /**
+     * Восстановление баланса изменяемого узла
+     * @param node узел
+     * @return новая вершина поддерева
+     */
+    static Node* balance(Node* node) {
+        update(node);
+
+        long long int balance = getBalance(node);
+
+        if (balance > 1) {
+            if (getBalance(node->left) < 0) {
+                node->left = own(node->left);
+                node->left = leftRotate(node->left);
+            }
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            if (getBalance(node->right) > 0) {
+                node->right = own(node->right);
+                node->right = rightRotate(node->right);
+            }
+            return leftRotate(node);
+        }
+
+        return node;
+    }
+
+    /**
+     * Рекурсивная вставка с копированием пути
+     * Путь копируется на подъёме и только если ключ вставлен, поэтому
+     * принадлежность узлов версии определяется заранее при спуске.
+     * Узел, принадлежащий только версии, изменяется на месте и возвращается
+     * вместо прежней ссылки, иначе возвращается копия с новой ссылкой.
+     * @param node вершина поддерева (ссылка остаётся у вызывающего)
+     * @param key ключ
+     * @param unique принадлежит ли узел только этой версии
+     * @param inserted сюда записывается, был ли ключ вставлен
+     * @return новая вершина поддерева (node, если ключ уже есть)
+     */
+    Node* insertNode(Node* node, const Type& key, bool unique, bool& inserted) {
+        if (node == nullptr) {
+            inserted = true;
+            return new Node(key, nullptr, nullptr, 1, 1);
+        }
+
+        bool less = compare(key, node->key);
+
+        if (!less && !compare(node->key, key))
+            return node;
+
+        Node* child = less ? node->left : node->right;
+        bool childUnique = isUnique(child, unique);
+        Node* result = insertNode(child, key, childUnique, inserted);
+
+        if (!inserted)
+            return node;
+
+        if (!unique)
+            node = copy(node);
+        relink(less ? node->left : node->right, result, childUnique);
+        return balance(node);
+    }
+
+    /**
+     * Рекурсивное удаление с копированием пути
+     * (соглашения те же, что у insertNode)
+     * @param node вершина поддерева (ссылка остаётся у вызывающего)
+     * @param key ключ
+     * @param unique принадлежит ли узел только этой версии
+     * @param removed сюда записывается, был ли ключ удалён
+     * @return новая вершина поддерева (node, если ключа нет)
+     */
+    Node* deleteNode(Node* node, const Type& key, bool unique, bool& removed) {
+        if (node == nullptr)
+            return nullptr;
+
+        bool less = compare(key, node->key);
+
+        if (!less && !compare(node->key, key)) {
+            removed = true;
+
+            if (node->left == nullptr || node->right == nullptr)
+                return detach(node, node->left != nullptr ? node->left : node->right, unique);
+
+            // Ключ заменяется наименьшим ключом правого поддерева
+            bool rightUnique = isUnique(node->right, unique);
+
+            if (!unique)
+                node = copy(node);
+            relink(node->right, deleteMin(node->right, rightUnique, node->key), rightUnique);
+            return balance(node);
+        }
+
+        Node* child = less ? node->left : node->right;
+        bool childUnique = isUnique(child, unique);
+        Node* result = deleteNode(child, key, childUnique, removed);
+
+        if (!removed)
+            return node;
+
+        if (!unique)
+            node = copy(node);
+        relink(less ? node->left : node->right, result, childUnique);
+        return balance(node);
+    }
+
+    /**
+     * Удаление наименьшего узла поддерева
+     * (соглашения те же, что у insertNode)
+     * @param node вершина поддерева (ссылка остаётся у вызывающего)
+     * @param unique принадлежит ли узел только этой версии
+     * @param key сюда копируется удалённый ключ
+     * @return новая вершина поддерева
+     */
+    static Node* deleteMin(Node* node, bool unique, Type& key) {
+        if (node->left == nullptr) {
+            key = node->key;
+            return detach(node, node->right, unique);
+        }
+
+        bool leftUnique = isUnique(node->left, unique);
+        Node* result = deleteMin(node->left, leftUnique, key);
+
+        if (!unique)
+            node = copy(node);
+        relink(node->left, result, leftUnique);
+        return balance(node);
+    }
+
+    /**
+     * Замена узла с не более чем одним потомком этим потомком
+     * @param node узел (ссылка остаётся у вызывающего)
+     * @param child единственный потомок или nullptr
+     * @param unique принадлежит ли узел только этой версии
+     * @return потомок, занимающий место узла
+     */
+    static Node* detach(Node* node, Node* child, bool unique) {
+        if (!unique)
+            return retain(child);
+
+        // Ссылка узла на потомка переходит вызывающему, узел удаляется
+        node->left = nullptr;
+        node->right = nullptr;
+        release(node);
+        return child;
+    }
+
+    template <class Visitor>
+    void rangeNode(const Node* node, const Type& lo, const Type& hi, Visitor& visitor) const {
+        if (node == nullptr)
+            return;
+
+        bool aboveLo = !compare(node->key, lo);
+        bool belowHi = !compare(hi, node->key);
+
+        if (aboveLo)
+            rangeNode(node->left, lo, hi, visitor);
+        if (aboveLo && belowHi)
+            visitor(node->key);
+        if (belowHi)
+            rangeNode(node->right, lo, hi, visitor);
+    }
+
+    template <class Visitor>
+    static void forEachNode(const Node* node, Visitor& visitor) {
+        if (node == nullptr)
+            return;
+
+        forEachNode(node->left, visitor);
+        visitor(node->key);
+        forEachNode(node->right, visitor);
+    }
+};
+
+#endif //AVLTREE_PERSISTENTAVLTREE_H
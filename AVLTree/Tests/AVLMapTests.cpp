@@ -0,0 +1,180 @@
+#undef NDEBUG
+#include <cassert>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../AVLMap.h"
+
+/**
+ * Сравнение содержимого словаря с эталоном в прямом и обратном порядке
+ */
+template <class Map, class Expected>
+void checkEqual(const Map& map, const Expected& expected) {
+    assert(map.getSize() == expected.size());
+
+    auto it = map.begin();
+    for (const auto& entry : expected) {
+        assert(it != map.end());
+        assert(it->first == entry.first && it->second == entry.second);
+        ++it;
+    }
+    assert(it == map.end());
+
+    for (auto rit = expected.rbegin(); rit != expected.rend(); ++rit) {
+        --it;
+        assert(it->first == rit->first && it->second == rit->second);
+    }
+    assert(it == map.begin());
+}
+
+/**
+ * Случайные операции сверяются с std::map
+ */
+void testRandomOperations() {
+    std::mt19937 random(13);
+    AVLMap<int, long long> map;
+    std::map<int, long long> expected;
+
+    for (int step = 0; step < 100000; ++step) {
+        int key = random() % 5000;
+        long long value = random() % 1000;
+
+        switch (random() % 8) {
+            case 0:
+                map[key] += value;
+                expected[key] += value;
+                break;
+            case 1: {
+                auto result = map.try_emplace(key, value);
+                auto expectedResult = expected.try_emplace(key, value);
+                assert(result.second == expectedResult.second);
+                assert(result.first->first == key && result.first->second == expectedResult.first->second);
+                break;
+            }
+            case 2: {
+                auto result = map.insert_or_assign(key, value);
+                assert(result.second == expected.insert_or_assign(key, value).second);
+                assert(result.first->second == value);
+                break;
+            }
+            case 3:
+            case 4:
+                assert(map.remove(key) == (expected.erase(key) > 0));
+                break;
+            case 5: {
+                // Значение изменяется через итератор без повторного поиска
+                auto it = map.find(key);
+                assert((it == map.end()) == (expected.count(key) == 0));
+                if (it != map.end()) {
+                    it->second *= 2;
+                    expected[key] *= 2;
+                }
+                break;
+            }
+            case 6: {
+                auto expectedIt = expected.find(key);
+                try {
+                    long long found = map.at(key);
+                    assert(expectedIt != expected.end() && found == expectedIt->second);
+                } catch (const std::out_of_range&) {
+                    assert(expectedIt == expected.end());
+                }
+                assert(map.exist(key) == (expectedIt != expected.end()));
+                break;
+            }
+            default: {
+                auto lower = map.lower_bound(key);
+                auto expectedLower = expected.lower_bound(key);
+                assert((lower == map.end()) == (expectedLower == expected.end()));
+                if (expectedLower != expected.end())
+                    assert(lower->first == expectedLower->first);
+
+                auto upper = map.upper_bound(key);
+                auto expectedUpper = expected.upper_bound(key);
+                assert((upper == map.end()) == (expectedUpper == expected.end()));
+                if (expectedUpper != expected.end())
+                    assert(upper->first == expectedUpper->first);
+            }
+        }
+
+        if (step % 25000 == 0)
+            checkEqual(map, expected);
+    }
+
+    checkEqual(map, expected);
+    map.clear();
+    assert(map.getSize() == 0 && map.begin() == map.end());
+}
+
+/**
+ * Значение, считающее создания
+ */
+struct Counted {
+    static int created;
+
+    int value;
+
+    explicit Counted(int value = 0) : value(value) {
+        created++;
+    }
+
+    Counted(const Counted& other) : value(other.value) {
+        created++;
+    }
+
+    Counted(Counted&& other) noexcept : value(other.value) {
+        created++;
+    }
+
+    Counted& operator=(const Counted& other) = default;
+    Counted& operator=(Counted&& other) = default;
+};
+
+int Counted::created = 0;
+
+/**
+ * try_emplace при существующем ключе не создаёт значение
+ * и не забирает ключ, переданный по ссылке на rvalue
+ */
+void testTryEmplace() {
+    AVLMap<std::string, Counted> map;
+
+    assert(map.try_emplace("a", 1).second);
+    assert(map.try_emplace(std::string(100, 'b'), 2).second);
+
+    Counted::created = 0;
+    std::string key(100, 'b');
+    auto result = map.try_emplace(std::move(key), 3);
+    assert(!result.second && result.first->second.value == 2);
+    assert(Counted::created == 0);
+    assert(key == std::string(100, 'b'));
+
+    // Новое значение конструируется на месте один раз
+    assert(map.try_emplace("c", 4).second);
+    assert(Counted::created == 1);
+
+    // operator[] для существующего ключа тоже ничего не создаёт
+    Counted::created = 0;
+    map["a"].value = 10;
+    assert(Counted::created == 0 && map.at("a").value == 10);
+
+    const AVLMap<std::string, Counted>& constMap = map;
+    assert(constMap.at("c").value == 4);
+    bool thrown = false;
+    try {
+        constMap.at("missing");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    testRandomOperations();
+    testTryEmplace();
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+
+/**
+ * Дерево со счётчиками: по наибольшей глубине спуска проверяется высота
+ */
+template <class Balance = AVLBalance>
+using CountedTree = AVLTree<int, std::less<int>, NodePool<Node<int>>, TreeStats, Balance>;
+
+/**
+ * Сравнение содержимого дерева с эталоном в прямом и обратном порядке
+ */
+template <class Tree>
+void checkEqual(const Tree& tree, const std::set<int>& expected) {
+    assert(tree.getSize() == expected.size());
+    assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+    assert(std::equal(std::make_reverse_iterator(tree.end()), std::make_reverse_iterator(tree.begin()),
+                      expected.rbegin(), expected.rend()));
+}
+
+/**
+ * Проверка высоты: поиск каждого ключа не глубже bound * Lg(n + 2)
+ */
+template <class Tree>
+void checkHeight(Tree& tree, const std::set<int>& expected, double bound) {
+    tree.resetStats();
+    for (int key : expected)
+        assert(tree.exist(key));
+    assert(tree.getStats().maxDepth <= bound * std::log2(expected.size() + 2.0));
+}
+
+/**
+ * Случайные операции сверяются с std::set
+ * @param tree - дерево
+ * @param seed - начальное значение генератора
+ * @param heightBound - множитель оценки высоты
+ */
+template <class Tree>
+void testRandomOperations(Tree& tree, unsigned seed, double heightBound) {
+    std::mt19937 random(seed);
+    std::set<int> expected;
+
+    for (int step = 0; step < 100000; ++step) {
+        int key = random() % 20000;
+        int operation = random() % 11;
+
+        if (operation < 3) {
+            assert(tree.insert(key).second == expected.insert(key).second);
+        } else if (operation == 3) {
+            auto it = tree.insert(tree.lower_bound(key + static_cast<int>(random() % 5) - 2), key);
+            expected.insert(key);
+            assert(*it == key);
+        } else if (operation == 4) {
+            auto result = tree.insertNearFinger(key);
+            assert(result.second == expected.insert(key).second && *result.first == key);
+        } else if (operation < 8) {
+            assert(tree.remove(key) == (expected.erase(key) > 0));
+        } else if (operation == 8) {
+            assert(tree.exist(key) == (expected.count(key) > 0));
+            assert((tree.find(key) == tree.end()) == (expected.find(key) == expected.end()));
+
+            auto lower = tree.lower_bound(key);
+            auto expectedLower = expected.lower_bound(key);
+            assert((lower == tree.end()) == (expectedLower == expected.end()));
+            if (expectedLower != expected.end())
+                assert(*lower == *expectedLower);
+
+            auto upper = tree.upper_bound(key);
+            auto expectedUpper = expected.upper_bound(key);
+            assert((upper == tree.end()) == (expectedUpper == expected.end()));
+            if (expectedUpper != expected.end())
+                assert(*upper == *expectedUpper);
+        } else if (operation == 9) {
+            assert(tree.rank(key) == static_cast<size_t>(std::distance(expected.begin(), expected.lower_bound(key))));
+
+            size_t index = random() % (expected.size() + 1);
+            auto it = tree.select(index);
+            if (index == expected.size())
+                assert(it == tree.end());
+            else
+                assert(*it == *std::next(expected.begin(), index));
+
+            int high = key + static_cast<int>(random() % 500);
+            size_t inRange = std::distance(expected.lower_bound(key), expected.upper_bound(high));
+            std::vector<int> visited;
+            assert(tree.count(key, high) == inRange);
+            tree.range(key, high, [&visited](const int& value) { visited.push_back(value); });
+            assert(std::equal(visited.begin(), visited.end(), expected.lower_bound(key), expected.upper_bound(high)));
+        } else {
+            int keys[40];
+            bool found[40];
+            for (int& value : keys)
+                value = random() % 20000;
+            tree.existBatch(keys, 40, found);
+            for (int i = 0; i < 40; ++i)
+                assert(found[i] == (expected.count(keys[i]) > 0));
+        }
+
+        if (step % 25000 == 0) {
+            checkEqual(tree, expected);
+            checkHeight(tree, expected, heightBound);
+        }
+    }
+
+    checkEqual(tree, expected);
+    checkHeight(tree, expected, heightBound);
+}
+
+/**
+ * Вставка почти упорядоченного потока по пальцу: возрастающий
+ * и убывающий потоки с разбросом до 64 позиций, ключи совпадают
+ * с std::set, а сравнений на вставку - порядка логарифма разброса
+ */
+void testNearlySortedInsert() {
+    const int n = 100000;
+
+    for (bool ascending : {true, false}) {
+        std::mt19937 random(ascending ? 7 : 8);
+        std::vector<std::pair<int, int>> arrivals;
+
+        for (int i = 0; i < n; ++i) {
+            int key = ascending ? i : n - i;
+            arrivals.emplace_back(i + static_cast<int>(random() % 64), key);
+        }
+        std::sort(arrivals.begin(), arrivals.end());
+
+        CountedTree<> tree;
+        std::set<int> expected;
+
+        for (const auto& arrival : arrivals) {
+            auto result = tree.insertNearFinger(arrival.second);
+            assert(result.second == expected.insert(arrival.second).second);
+            assert(*result.first == arrival.second);
+        }
+
+        checkEqual(tree, expected);
+        assert(tree.getStats().comparisons < 16ull * n);
+    }
+}
+
+/**
+ * Построение из отсортированной и произвольной последовательности,
+ * замороженный снимок
+ */
+void testBuild() {
+    std::vector<int> sorted;
+    for (int i = 0; i < 100000; i += 3)
+        sorted.push_back(i);
+
+    CountedTree<> tree;
+    tree.buildFromSorted(sorted.begin(), sorted.end());
+    std::set<int> expected(sorted.begin(), sorted.end());
+    checkEqual(tree, expected);
+
+    // Построенное дерево идеально сбалансировано
+    for (int key : sorted)
+        assert(tree.exist(key));
+    assert(tree.getStats().maxDepth == std::ceil(std::log2(sorted.size() + 1.0)));
+
+    std::vector<int> shuffled = {5, 1, 9, 1, 7, 3, 5};
+    AVLTree<int> built;
+    built.build(shuffled.begin(), shuffled.end());
+    checkEqual(built, std::set<int>(shuffled.begin(), shuffled.end()));
+
+    auto frozen = tree.freeze();
+    assert(frozen.getSize() == expected.size());
+    assert(std::equal(frozen.begin(), frozen.end(), expected.begin(), expected.end()));
+    for (int key = -1; key < 100002; key += 7) {
+        assert(frozen.exist(key) == (expected.count(key) > 0));
+        auto lower = frozen.lower_bound(key);
+        auto expectedLower = expected.lower_bound(key);
+        assert((lower == frozen.end()) == (expectedLower == expected.end()));
+        if (expectedLower != expected.end())
+            assert(*lower == *expectedLower);
+    }
+}
+
+/**
+ * Счётчики поворотов и сравнений
+ */
+void testStats() {
+    CountedTree<> tree;
+
+    for (int i = 0; i < 1000; ++i)
+        tree.insert(i);
+
+    TreeCounters counters = tree.getStats();
+    assert(counters.singleRotations > 0);
+    assert(counters.comparisons > 0);
+    assert(counters.operations == 1000);
+    assert(counters.nodes == 1000);
+
+    tree.resetStats();
+    assert(tree.getStats().operations == 0);
+}
+
+/**
+ * Прозрачный поиск и конструирование ключа на месте
+ */
+void testTransparentLookup() {
+    AVLTree<std::string, std::less<>> tree;
+
+    assert(tree.emplace(3, 'a').second);
+    assert(!tree.emplace("aaa").second);
+    tree.insert(std::string("b"));
+
+    assert(tree.exist("aaa"));
+    assert(tree.find("b") != tree.end());
+    assert(*tree.lower_bound("ab") == "b");
+    assert(tree.remove("aaa"));
+    assert(tree.getSize() == 1);
+}
+
+/**
+ * Ключ, считающий живые экземпляры
+ */
+struct LiveKey {
+    static int live;
+
+    int value;
+
+    explicit LiveKey(int value) : value(value) {
+        live++;
+    }
+
+    LiveKey(const LiveKey& other) : value(other.value) {
+        live++;
+    }
+
+    ~LiveKey() {
+        live--;
+    }
+
+    bool operator<(const LiveKey& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+int LiveKey::live = 0;
+
+/**
+ * emplace ключа, оставшегося помеченным удалённым узлом: узел
+ * восстанавливается, а построенный emplace узел разрушается
+ */
+void testEmplaceOverTombstone() {
+    {
+        AVLTree<LiveKey, std::less<LiveKey>, NodeAllocator<Node<LiveKey>>> tree;
+        tree.setLazyDeletion(0.9);
+
+        for (int i = 0; i < 10; ++i)
+            tree.emplace(i);
+        assert(tree.remove(LiveKey(5)));
+
+        auto result = tree.emplace(5);
+        assert(result.second && result.first->value == 5);
+        assert(tree.getSize() == 10 && tree.exist(LiveKey(5)));
+        assert(LiveKey::live == 10);
+
+        // Ключ уже есть: новый узел тоже разрушается
+        assert(!tree.emplace(5).second);
+        assert(LiveKey::live == 10);
+    }
+
+    assert(LiveKey::live == 0);
+}
+
+/**
+ * Ленивое удаление: помеченные узлы пропускаются, дерево перестраивается
+ * при превышении доли помеченных, признак не увеличивает узел
+ */
+void testLazyDeletion() {
+    if (sizeof(void*) == 8)
+        assert(sizeof(Node<long long int>) == 48);
+
+    for (double fraction : {0.1, 0.5, 0.9}) {
+        CountedTree<> tree;
+        tree.setLazyDeletion(fraction);
+        testRandomOperations(tree, 3, 2.0);
+    }
+
+    std::set<int> expected;
+    AVLTree<int> tree;
+    tree.setLazyDeletion(0.9);
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(i);
+        expected.insert(i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        tree.remove(i);
+        expected.erase(i);
+    }
+    checkEqual(tree, expected);
+    assert(tree.rank(501) == 250 && *tree.select(250) == 501);
+
+    // Повторная вставка восстанавливает помеченный узел
+    assert(tree.insert(10).second && tree.exist(10));
+    expected.insert(10);
+    tree.purge();
+    checkEqual(tree, expected);
+    tree.setLazyDeletion(0);
+    assert(tree.remove(11) && !tree.exist(11));
+}
+
+int main() {
+    CountedTree<> tree;
+    testRandomOperations(tree, 1, 1.45);
+
+    CountedTree<WAVLBalance> relaxed;
+    testRandomOperations(relaxed, 2, 2.0);
+
+    testNearlySortedInsert();
+    testBuild();
+    testStats();
+    testTransparentLookup();
+    testLazyDeletion();
+    testEmplaceOverTombstone();
+
+    return 0;
+}
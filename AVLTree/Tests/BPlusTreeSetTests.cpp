@@ -0,0 +1,161 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+#include "../BPlusTreeSet.h"
+
+/**
+ * Сравнение с эталоном: размер, прямой и обратный обход
+ */
+template <class Type, class Compare>
+void checkEqual(const BPlusTreeSet<Type, Compare>& tree, const std::set<Type, Compare>& expected) {
+    assert(tree.getSize() == expected.size());
+    assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+    auto it = tree.end();
+    for (auto rit = expected.rbegin(); rit != expected.rend(); ++rit)
+        assert(*--it == *rit);
+    assert(it == tree.begin());
+}
+
+/**
+ * Поиск, границы и отрезок совпадают с эталоном
+ */
+template <class Type, class Compare>
+void checkLookup(const BPlusTreeSet<Type, Compare>& tree, const std::set<Type, Compare>& expected,
+                 const Type& key, const Type& high) {
+    assert(tree.exist(key) == (expected.count(key) > 0));
+    assert((tree.find(key) == tree.end()) == (expected.find(key) == expected.end()));
+
+    auto lower = tree.lower_bound(key);
+    auto expectedLower = expected.lower_bound(key);
+    assert((lower == tree.end()) == (expectedLower == expected.end()));
+    if (expectedLower != expected.end())
+        assert(*lower == *expectedLower);
+
+    auto upper = tree.upper_bound(key);
+    auto expectedUpper = expected.upper_bound(key);
+    assert((upper == tree.end()) == (expectedUpper == expected.end()));
+    if (expectedUpper != expected.end())
+        assert(*upper == *expectedUpper);
+
+    std::vector<Type> visited;
+    tree.range(key, high, [&visited](const Type& value) { visited.push_back(value); });
+    if (expected.key_comp()(high, key))
+        assert(visited.empty());
+    else
+        assert(std::equal(visited.begin(), visited.end(), expected.lower_bound(key), expected.upper_bound(high)));
+}
+
+/**
+ * Случайные операции сверяются с std::set; узкий диапазон ключей
+ * заставляет листья и внутренние узлы многократно делиться,
+ * занимать ключи у соседей и сливаться
+ * @param keyOf - ключ по случайному числу
+ */
+template <class Type, class Compare, class KeyOf>
+void testRandomOperations(unsigned seed, KeyOf keyOf) {
+    std::mt19937 random(seed);
+    BPlusTreeSet<Type, Compare> tree;
+    std::set<Type, Compare> expected;
+
+    for (int step = 0; step < 100000; ++step) {
+        // Размер множества то растёт, то уменьшается
+        int phase = (step / 25000) % 2;
+        Type key = keyOf(random() % 20000);
+        int operation = random() % 10;
+
+        if (operation < (phase == 0 ? 5 : 2)) {
+            auto result = tree.insert(key);
+            assert(result.second == expected.insert(key).second);
+            assert(*result.first == key);
+        } else if (operation < 8) {
+            assert(tree.remove(key) == (expected.erase(key) > 0));
+        } else {
+            checkLookup(tree, expected, key, keyOf(random() % 20000));
+        }
+
+        if (step % 20000 == 0)
+            checkEqual(tree, expected);
+    }
+
+    checkEqual(tree, expected);
+}
+
+/**
+ * Удаление всех ключей по возрастанию, по убыванию и вразброс
+ * (слияния доходят до корня, дерево становится пустым)
+ */
+void testRemoveAll() {
+    const int64_t n = 30000;
+
+    for (int order = 0; order < 3; ++order) {
+        BPlusTreeSet<int64_t> tree;
+        std::vector<int64_t> keys;
+
+        for (int64_t i = 0; i < n; ++i) {
+            keys.push_back(i * 3);
+            tree.insert(i * 3);
+        }
+
+        if (order == 1)
+            std::reverse(keys.begin(), keys.end());
+        else if (order == 2)
+            std::shuffle(keys.begin(), keys.end(), std::mt19937(order));
+
+        std::set<int64_t> expected(keys.begin(), keys.end());
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            assert(tree.remove(keys[i]));
+            expected.erase(keys[i]);
+            if (i % 4999 == 0)
+                checkEqual(tree, expected);
+        }
+
+        assert(tree.getSize() == 0 && tree.begin() == tree.end());
+        assert(!tree.remove(0) && !tree.exist(0));
+
+        // Дерево после опустошения снова работает
+        tree.insert(5);
+        assert(tree.exist(5) && *tree.begin() == 5);
+    }
+}
+
+/**
+ * Крайние значения типа (для SIMD поиска - знаковое сравнение)
+ */
+void testLimits() {
+    BPlusTreeSet<int64_t> tree;
+    std::set<int64_t> expected;
+    const int64_t low = std::numeric_limits<int64_t>::min();
+    const int64_t high = std::numeric_limits<int64_t>::max();
+
+    for (int64_t i = 0; i < 1000; ++i) {
+        for (int64_t key : {low + i, high - i, i - 500}) {
+            tree.insert(key);
+            expected.insert(key);
+        }
+    }
+
+    checkEqual(tree, expected);
+    for (int64_t key : {low, low + 1, int64_t(-1), int64_t(0), high - 1, high})
+        checkLookup(tree, expected, key, high);
+}
+
+int main() {
+    // Стандартный порядок: при сборке с AVX2 / SSE4.2 - SIMD поиск в узле
+    testRandomOperations<int64_t, std::less<int64_t>>(1, [](unsigned value) { return int64_t(value) - 10000; });
+    testRandomOperations<int32_t, std::less<int32_t>>(2, [](unsigned value) { return int32_t(value); });
+    // Другой порядок - всегда линейный подсчёт
+    testRandomOperations<int64_t, std::greater<int64_t>>(3, [](unsigned value) { return int64_t(value); });
+    testRemoveAll();
+    testLimits();
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include "../CompactAVLTree.h"
+
+/**
+ * Случайные операции сверяются с std::set
+ */
+void testRandomOperations() {
+    std::mt19937 random(19);
+    CompactAVLTree<int> tree;
+    std::set<int> expected;
+
+    for (int step = 0; step < 200000; ++step) {
+        int key = random() % 20000;
+        int operation = random() % 6;
+
+        if (operation < 2) {
+            auto result = tree.insert(key);
+            assert(result.second == expected.insert(key).second);
+            assert(*result.first == key);
+        } else if (operation < 4) {
+            assert(tree.remove(key) == (expected.erase(key) > 0));
+        } else if (operation == 4) {
+            assert(tree.exist(key) == (expected.count(key) > 0));
+
+            auto lower = tree.lower_bound(key);
+            auto expectedLower = expected.lower_bound(key);
+            assert((lower == tree.end()) == (expectedLower == expected.end()));
+            if (expectedLower != expected.end())
+                assert(*lower == *expectedLower);
+
+            auto upper = tree.upper_bound(key);
+            auto expectedUpper = expected.upper_bound(key);
+            assert((upper == tree.end()) == (expectedUpper == expected.end()));
+            if (expectedUpper != expected.end())
+                assert(*upper == *expectedUpper);
+        } else {
+            assert(tree.rank(key) == static_cast<size_t>(std::distance(expected.begin(), expected.lower_bound(key))));
+
+            size_t index = random() % (expected.size() + 1);
+            auto it = tree.select(index);
+            if (index == expected.size())
+                assert(it == tree.end());
+            else
+                assert(*it == *std::next(expected.begin(), index));
+
+            int high = key + static_cast<int>(random() % 500);
+            assert(tree.count(key, high) ==
+                   static_cast<size_t>(std::distance(expected.lower_bound(key), expected.upper_bound(high))));
+        }
+
+        if (step % 20000 == 0) {
+            assert(tree.getSize() == expected.size());
+            assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+            assert(std::equal(std::make_reverse_iterator(tree.end()), std::make_reverse_iterator(tree.begin()),
+                              expected.rbegin(), expected.rend()));
+        }
+    }
+}
+
+/**
+ * Перемещение, конструирование на месте и прозрачный поиск
+ */
+void testKeysAndTransparentLookup() {
+    CompactAVLTree<std::string, std::less<>> tree;
+
+    std::string first(40, 'x');
+    assert(tree.insert(std::move(first)).second);
+    assert(first.empty());
+
+    // Уже имеющийся ключ не перемещается
+    std::string again(40, 'x');
+    assert(!tree.insert(std::move(again)).second);
+    assert(again.size() == 40);
+
+    assert(tree.emplace(3, 'a').second);
+    assert(!tree.emplace("aaa").second);
+
+    assert(tree.exist("aaa"));
+    assert(tree.find("aaa") != tree.end());
+    assert(*tree.lower_bound("ab") == std::string(40, 'x'));
+    assert(tree.upper_bound(std::string(40, 'x')) == tree.end());
+    assert(tree.remove("aaa"));
+    assert(!tree.remove("aaa"));
+    assert(tree.getSize() == 1);
+}
+
+int main() {
+    testRandomOperations();
+    testKeysAndTransparentLookup();
+
+    return 0;
+}
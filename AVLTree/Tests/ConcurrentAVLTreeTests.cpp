@@ -0,0 +1,312 @@
+#undef NDEBUG
+#include <atomic>
+#include <cassert>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include "../ConcurrentAVLTree.h"
+
+/**
+ * Ключ, считающий живые экземпляры (то есть неосвобождённые узлы)
+ */
+struct CountedKey {
+    static std::atomic<long> live;
+
+    int value;
+
+    explicit CountedKey(int value) : value(value) {
+        live++;
+    }
+
+    CountedKey(const CountedKey& other) : value(other.value) {
+        live++;
+    }
+
+    ~CountedKey() {
+        live--;
+    }
+
+    bool operator<(const CountedKey& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+std::atomic<long> CountedKey::live(0);
+
+/**
+ * Однопоточная работа совпадает с std::set
+ */
+void testRandomOperations() {
+    std::mt19937 random(11);
+    ConcurrentAVLTree<int> tree;
+    std::set<int> expected;
+
+    for (int step = 0; step < 200000; ++step) {
+        int key = random() % 3000;
+
+        switch (random() % 3) {
+            case 0:
+                assert(tree.insert(key) == expected.insert(key).second);
+                break;
+            case 1:
+                assert(tree.remove(key) == (expected.erase(key) > 0));
+                break;
+            default:
+                assert(tree.exist(key) == (expected.count(key) > 0));
+                assert(tree.find(key).has_value() == (expected.count(key) > 0));
+        }
+    }
+
+    assert(tree.getSize() == expected.size());
+}
+
+/**
+ * Запись, упорядоченная только по номеру
+ */
+struct Record {
+    int id;
+    int value;
+
+    bool operator<(const Record& rhs) const {
+        return id < rhs.id;
+    }
+};
+
+/**
+ * find возвращает копию хранимого ключа
+ */
+void testFind() {
+    ConcurrentAVLTree<Record> tree;
+
+    for (int i = 0; i < 1000; ++i)
+        tree.insert(Record{i, i * 10});
+
+    std::optional<Record> found = tree.find(Record{500, 0});
+    assert(found.has_value() && found->id == 500 && found->value == 5000);
+
+    tree.remove(Record{500, 0});
+    assert(!tree.find(Record{500, 0}).has_value());
+    assert(!tree.find(Record{1000, 0}).has_value());
+}
+
+/**
+ * Вырезанные узлы освобождаются без явного вызова:
+ * неосвобождённых узлов не больше размера дерева и нескольких пачек
+ */
+void testReclamation() {
+    {
+        std::mt19937 random(12);
+        ConcurrentAVLTree<CountedKey> tree;
+
+        for (int step = 0; step < 100000; ++step) {
+            CountedKey key(random() % 2000);
+
+            if (random() % 2 == 0)
+                tree.insert(key);
+            else
+                tree.remove(key);
+        }
+
+        assert(CountedKey::live - (long) tree.getSize() < 1000);
+    }
+
+    assert(CountedKey::live == 0);
+}
+
+/**
+ * Читатели работают одновременно с писателями: чётные ключи есть
+ * всё время, ключей за пределами диапазона нет никогда, а память
+ * вырезанных узлов освобождается после выхода читателей
+ */
+void testReadersAndWriters() {
+    const int n = 20000;
+    {
+        ConcurrentAVLTree<CountedKey> tree;
+
+        for (int i = 0; i < n; i += 2)
+            tree.insert(CountedKey(i));
+
+        std::atomic<bool> stop(false);
+        std::atomic<long> errors(0);
+        std::vector<std::thread> readers;
+        std::vector<std::thread> writers;
+
+        for (int r = 0; r < 4; ++r) {
+            readers.emplace_back([&tree, &stop, &errors, r, n]() {
+                std::mt19937 random(r + 20);
+
+                while (!stop.load()) {
+                    int key = random() % n;
+
+                    if (key % 2 == 0 && !tree.exist(CountedKey(key)))
+                        errors++;
+                    if (tree.exist(CountedKey(n + 1 + (int) (random() % 100))))
+                        errors++;
+
+                    std::optional<CountedKey> found = tree.find(CountedKey(key));
+                    if (found.has_value() && found->value != key)
+                        errors++;
+                }
+            });
+        }
+
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&tree, w, n]() {
+                std::mt19937 random(w + 30);
+
+                for (int step = 0; step < 100000; ++step) {
+                    CountedKey key((int) (random() % (n / 2)) * 2 + 1);
+
+                    if (random() % 2 == 0)
+                        tree.insert(key);
+                    else
+                        tree.remove(key);
+                }
+            });
+        }
+
+        for (std::thread& writer : writers)
+            writer.join();
+        stop = true;
+        for (std::thread& reader : readers)
+            reader.join();
+
+        assert(errors == 0);
+
+        // Вытесненный читатель может надолго задержать эпоху, но после
+        // выхода читателей несколько записей освобождают накопленные узлы
+        for (int key = 1; key < 2000; key += 2) {
+            tree.insert(CountedKey(key));
+            tree.remove(CountedKey(key));
+        }
+        assert(CountedKey::live - (long) tree.getSize() < 1000);
+    }
+
+    assert(CountedKey::live == 0);
+}
+
+/**
+ * Писатели на общих ключах: по каждому ключу число успешных вставок
+ * минус число успешных удалений совпадает с итоговым наличием ключа
+ */
+void testContendedWriters() {
+    const int n = 500;
+    const int writers = 4;
+    ConcurrentAVLTree<int> tree;
+    std::vector<std::vector<int>> balances(writers, std::vector<int>(n, 0));
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&tree, &balances, w, n]() {
+            std::mt19937 random(w + 40);
+
+            for (int step = 0; step < 100000; ++step) {
+                int key = random() % n;
+
+                if (random() % 2 == 0)
+                    balances[w][key] += tree.insert(key);
+                else
+                    balances[w][key] -= tree.remove(key);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    size_t present = 0;
+
+    for (int key = 0; key < n; ++key) {
+        int balance = 0;
+
+        for (int w = 0; w < writers; ++w)
+            balance += balances[w][key];
+
+        assert(balance == 0 || balance == 1);
+        assert(tree.exist(key) == (balance == 1));
+        present += balance;
+    }
+
+    assert(tree.getSize() == present);
+}
+
+/**
+ * Писатели на непересекающихся диапазонах вместе с читателями:
+ * итог каждого диапазона совпадает с std::set его писателя, после
+ * одновременных поворотов дерево продолжает работать как множество
+ */
+void testDisjointWriters() {
+    const int n = 10000;
+    const int writers = 4;
+    ConcurrentAVLTree<int> tree;
+    std::vector<std::set<int>> expected(writers);
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop(false);
+    std::atomic<long> errors(0);
+
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&tree, &expected, w, n]() {
+            std::mt19937 random(w + 50);
+
+            for (int step = 0; step < 100000; ++step) {
+                // Ключи писателя w перемежаются с ключами остальных
+                int key = (int) (random() % n) * writers + w;
+
+                if (random() % 3 != 0)
+                    assert(tree.insert(key) == expected[w].insert(key).second);
+                else
+                    assert(tree.remove(key) == (expected[w].erase(key) > 0));
+            }
+        });
+    }
+
+    // Отрицательных ключей никто не вставляет
+    threads.emplace_back([&tree, &stop, &errors]() {
+        std::mt19937 random(60);
+
+        while (!stop.load()) {
+            if (tree.exist(-1 - (int) (random() % 1000)))
+                errors++;
+        }
+    });
+
+    for (int w = 0; w < writers; ++w)
+        threads[w].join();
+    stop = true;
+    threads.back().join();
+
+    assert(errors == 0);
+
+    std::set<int> all;
+    for (const std::set<int>& keys : expected)
+        all.insert(keys.begin(), keys.end());
+
+    assert(tree.getSize() == all.size());
+    for (int key = 0; key < n * writers; ++key)
+        assert(tree.exist(key) == (all.count(key) > 0));
+
+    // Однопоточное продолжение на том же дереве
+    std::mt19937 random(70);
+    for (int step = 0; step < 50000; ++step) {
+        int key = random() % (n * writers);
+
+        if (random() % 2 == 0)
+            assert(tree.insert(key) == all.insert(key).second);
+        else
+            assert(tree.remove(key) == (all.erase(key) > 0));
+    }
+    assert(tree.getSize() == all.size());
+}
+
+int main() {
+    testRandomOperations();
+    testFind();
+    testReclamation();
+    testReadersAndWriters();
+    testContendedWriters();
+    testDisjointWriters();
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#undef NDEBUG
+#include <cassert>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../IntervalTree.h"
+
+/**
+ * Поиск пересечений сверяется с полным перебором
+ */
+void testRandomOverlaps() {
+    std::mt19937 random(17);
+    IntervalTree<int> tree;
+    std::set<std::pair<int, int>> expected;
+
+    for (int step = 0; step < 40000; ++step) {
+        int low = random() % 10000;
+        int high = low + random() % 300;
+
+        if (random() % 3 != 0) {
+            assert(tree.insert(low, high) == expected.insert({low, high}).second);
+        } else {
+            auto it = expected.lower_bound({low, 0});
+            if (it != expected.end()) {
+                assert(tree.remove(it->first, it->second));
+                expected.erase(it);
+            }
+        }
+
+        if (step % 100 != 0)
+            continue;
+
+        int a = random() % 10000;
+        int b = a + random() % 200;
+        std::vector<std::pair<int, int>> found;
+        std::vector<std::pair<int, int>> brute;
+
+        tree.overlaps(a, b, [&found](const Interval<int>& interval) {
+            found.push_back({interval.low, interval.high});
+        });
+        for (const auto& interval : expected)
+            if (interval.first <= b && a <= interval.second)
+                brute.push_back(interval);
+
+        assert(found == brute);
+        assert(tree.intersects(a, b) == !brute.empty());
+        assert(tree.getSize() == expected.size());
+    }
+}
+
+/**
+ * Точечные отрезки, касание концов и некорректные отрезки
+ */
+void testEdges() {
+    IntervalTree<int> tree;
+
+    assert(tree.insert(5, 5));
+    assert(!tree.insert(5, 5));
+    assert(tree.insert(1, 3));
+    assert(tree.intersects(3, 4));
+    assert(!tree.intersects(4, 4));
+    assert(tree.intersects(5, 9));
+
+    bool thrown = false;
+    try {
+        tree.insert(7, 6);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(tree.getSize() == 2);
+    assert(!tree.remove(7, 6));
+}
+
+int main() {
+    testRandomOverlaps();
+    testEdges();
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+#include "../PersistentAVLTree.h"
+
+/**
+ * Сравнение версии с эталоном: итераторы, поиск и размер
+ */
+void checkEqual(const PersistentAVLTree<int>& tree, const std::set<int>& expected) {
+    assert(tree.getSize() == expected.size());
+    assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+    std::vector<int> visited;
+    tree.forEach([&visited](const int& key) { visited.push_back(key); });
+    assert(std::equal(visited.begin(), visited.end(), expected.begin(), expected.end()));
+}
+
+/**
+ * Снимки не меняются при изменении дерева и друг друга
+ */
+void testSnapshots() {
+    std::mt19937 random(5);
+    PersistentAVLTree<int> tree;
+    std::set<int> expected;
+    std::vector<PersistentAVLTree<int>> snapshots;
+    std::vector<std::set<int>> snapshotKeys;
+
+    for (int step = 0; step < 60000; ++step) {
+        int key = random() % 5000;
+
+        if (random() % 2 == 0)
+            assert(tree.insert(key) == expected.insert(key).second);
+        else
+            assert(tree.remove(key) == (expected.erase(key) > 0));
+
+        if (step % 3000 == 0) {
+            snapshots.push_back(tree.snapshot());
+            snapshotKeys.push_back(expected);
+        }
+
+        if (step % 500 == 0) {
+            assert(tree.exist(key) == (expected.count(key) > 0));
+            assert((tree.find(key) == tree.end()) == (expected.count(key) == 0));
+
+            auto lower = tree.lower_bound(key);
+            auto upper = tree.upper_bound(key);
+            assert((lower == tree.end()) == (expected.lower_bound(key) == expected.end()));
+            assert((upper == tree.end()) == (expected.upper_bound(key) == expected.end()));
+            if (lower != tree.end())
+                assert(*lower == *expected.lower_bound(key));
+            if (upper != tree.end())
+                assert(*upper == *expected.upper_bound(key));
+        }
+    }
+
+    checkEqual(tree, expected);
+    for (size_t i = 0; i < snapshots.size(); ++i)
+        checkEqual(snapshots[i], snapshotKeys[i]);
+
+    // Изменение снимка не видно в дереве
+    snapshots[3].insert(-1);
+    snapshots[3].clear();
+    checkEqual(tree, expected);
+    checkEqual(snapshots[4], snapshotKeys[4]);
+}
+
+/**
+ * Ключ, считающий свои копии
+ */
+struct CountedKey {
+    static int copies;
+
+    int value;
+
+    explicit CountedKey(int value) : value(value) {}
+
+    CountedKey(const CountedKey& other) : value(other.value) {
+        copies++;
+    }
+
+    CountedKey& operator=(const CountedKey& other) {
+        value = other.value;
+        copies++;
+        return *this;
+    }
+
+    bool operator<(const CountedKey& rhs) const {
+        return value < rhs.value;
+    }
+};
+
+int CountedKey::copies = 0;
+
+/**
+ * Вставка имеющегося и удаление отсутствующего ключа
+ * не копируют путь даже в разделяемой версии
+ */
+void testNoCopyWithoutChange() {
+    PersistentAVLTree<CountedKey> tree;
+
+    for (int i = 0; i < 1000; i += 2)
+        tree.insert(CountedKey(i));
+
+    PersistentAVLTree<CountedKey> snapshot = tree.snapshot();
+
+    CountedKey::copies = 0;
+    assert(!tree.insert(CountedKey(500)));
+    assert(!tree.remove(CountedKey(501)));
+    assert(CountedKey::copies == 0);
+
+    // Изменение разделяемой версии копирует только путь
+    assert(tree.insert(CountedKey(501)));
+    assert(CountedKey::copies > 0 && CountedKey::copies < 40);
+    assert(!snapshot.exist(CountedKey(501)) && tree.exist(CountedKey(501)));
+}
+
+/**
+ * Читатели обходят свои снимки, пока писатель меняет дерево
+ */
+void testConcurrentReaders() {
+    PersistentAVLTree<int> tree;
+
+    for (int i = 0; i < 20000; ++i)
+        tree.insert(i);
+
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([snapshot = tree.snapshot()]() {
+            for (int round = 0; round < 20; ++round) {
+                size_t count = 0;
+                int previous = -1;
+
+                for (int key : snapshot) {
+                    assert(key > previous);
+                    previous = key;
+                    count++;
+                }
+                assert(count == 20000);
+            }
+        });
+    }
+
+    for (int i = 0; i < 20000; i += 3)
+        tree.remove(i);
+    for (std::thread& reader : readers)
+        reader.join();
+
+    assert(tree.getSize() == 20000 - 6667);
+}
+
+int main() {
+    testSnapshots();
+    testNoCopyWithoutChange();
+    testConcurrentReaders();
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+
+/**
+ * Дерево со счётчиками: по наибольшей глубине спуска проверяется высота
+ */
+using CountedTree = AVLTree<int, std::less<int>, NodePool<Node<int>>, TreeStats>;
+
+/**
+ * Сравнение содержимого дерева с эталоном
+ */
+template <class Tree, class Type>
+void checkEqual(const Tree& tree, const std::set<Type>& expected) {
+    assert(tree.getSize() == expected.size());
+    assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+}
+
+/**
+ * Содержимое, порядковые статистики и высота AVL дерева
+ * (поиск каждого ключа не глубже 1.45 * Lg(n + 2))
+ */
+void checkTree(CountedTree& tree, const std::set<int>& expected) {
+    checkEqual(tree, expected);
+
+    tree.resetStats();
+    for (int key : expected)
+        assert(tree.exist(key));
+    assert(tree.getStats().maxDepth <= 1.45 * std::log2(expected.size() + 2.0));
+
+    if (!expected.empty()) {
+        size_t index = expected.size() / 2;
+        assert(*tree.select(index) == *std::next(expected.begin(), index));
+        assert(tree.rank(*std::next(expected.begin(), index)) == index);
+    }
+}
+
+/**
+ * Заполнение дерева и эталона случайными ключами из [low, high)
+ */
+void fill(CountedTree& tree, std::set<int>& expected, std::mt19937& random, size_t count, int low, int high) {
+    for (size_t i = 0; i < count; ++i) {
+        int key = low + static_cast<int>(random() % (high - low));
+        tree.insert(key);
+        expected.insert(key);
+    }
+}
+
+/**
+ * Объединение, пересечение и разность случайных множеств
+ * размеров n и m (большие размеры идут по параллельной ветви)
+ * @param shared - деревья разделяют один пул (узлы не копируются)
+ */
+void testSetOperations(size_t n, size_t m, bool shared, unsigned seed) {
+    for (int operation = 0; operation < 3; ++operation) {
+        std::mt19937 random(seed + operation);
+        NodePool<Node<int>> pool;
+        CountedTree first = shared ? CountedTree(pool) : CountedTree();
+        CountedTree second = shared ? CountedTree(pool) : CountedTree();
+        std::set<int> firstKeys;
+        std::set<int> secondKeys;
+        int range = static_cast<int>(2 * (n + m) + 1);
+
+        fill(first, firstKeys, random, n, 0, range);
+        fill(second, secondKeys, random, m, range / 4, range);
+
+        std::set<int> expected;
+
+        switch (operation) {
+            case 0:
+                first.unionWith(second);
+                std::set_union(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                               std::inserter(expected, expected.end()));
+                break;
+            case 1:
+                first.intersect(second);
+                std::set_intersection(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                                      std::inserter(expected, expected.end()));
+                break;
+            default:
+                first.difference(second);
+                std::set_difference(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                                    std::inserter(expected, expected.end()));
+        }
+
+        checkTree(first, expected);
+        assert(second.getSize() == 0 && second.begin() == second.end());
+
+        // Деревья остаются рабочими
+        first.insert(-1);
+        second.insert(-1);
+        assert(first.exist(-1) && second.getSize() == 1);
+    }
+}
+
+/**
+ * Соединение деревьев разной высоты и разделение по ключу
+ */
+void testJoinSplit() {
+    std::mt19937 random(21);
+    const size_t sizes[] = {0, 1, 2, 7, 100, 5000};
+
+    for (size_t n : sizes) {
+        for (size_t m : sizes) {
+            CountedTree first;
+            CountedTree second;
+            std::set<int> expected;
+
+            fill(first, expected, random, n, 0, 100000);
+            fill(second, expected, random, m, 100000, 200000);
+
+            first.join(second);
+            checkTree(first, expected);
+            assert(second.getSize() == 0);
+        }
+    }
+
+    CountedTree tree;
+    std::set<int> keys;
+    fill(tree, keys, random, 20000, 0, 50000);
+
+    for (int key : {-1, 0, 777, 25000, 49999, 50000, *keys.begin(), *keys.rbegin()}) {
+        CountedTree greater;
+        greater.insert(123456);
+
+        tree.split(key, greater);
+
+        std::set<int> less(keys.begin(), keys.lower_bound(key));
+        std::set<int> notLess(keys.lower_bound(key), keys.end());
+        checkTree(tree, less);
+        checkTree(greater, notLess);
+
+        // Обратное соединение восстанавливает дерево
+        tree.join(greater);
+        checkTree(tree, keys);
+    }
+}
+
+/**
+ * Операции над деревьями с помеченными удалёнными узлами
+ * (помеченные узлы вычищаются до операции)
+ */
+void testLazyDeleted() {
+    std::mt19937 random(31);
+    CountedTree first;
+    CountedTree second;
+    std::set<int> firstKeys;
+    std::set<int> secondKeys;
+
+    first.setLazyDeletion(0.9);
+    second.setLazyDeletion(0.9);
+    fill(first, firstKeys, random, 3000, 0, 6000);
+    fill(second, secondKeys, random, 3000, 3000, 9000);
+    for (int key = 0; key < 9000; key += 3) {
+        first.remove(key);
+        firstKeys.erase(key);
+        second.remove(key);
+        secondKeys.erase(key);
+    }
+
+    std::set<int> expected;
+    std::set_union(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                   std::inserter(expected, expected.end()));
+
+    first.unionWith(second);
+    checkTree(first, expected);
+}
+
+/**
+ * Ключи с нетривиальным деструктором в разных пулах: ключи второго
+ * дерева копируются, узлы-дубликаты и исключённые узлы освобождаются
+ */
+void testStrings() {
+    std::mt19937 random(41);
+
+    for (int operation = 0; operation < 3; ++operation) {
+        AVLTree<std::string> first;
+        AVLTree<std::string> second;
+        std::set<std::string> firstKeys;
+        std::set<std::string> secondKeys;
+
+        for (int i = 0; i < 30000; ++i) {
+            std::string key = "key-with-a-long-prefix-" + std::to_string(random() % 40000);
+            first.insert(key);
+            firstKeys.insert(key);
+            key = "key-with-a-long-prefix-" + std::to_string(random() % 40000);
+            second.insert(key);
+            secondKeys.insert(key);
+        }
+
+        std::set<std::string> expected;
+
+        if (operation == 0) {
+            first.unionWith(second);
+            std::set_union(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                           std::inserter(expected, expected.end()));
+        } else if (operation == 1) {
+            first.intersect(second);
+            std::set_intersection(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                                  std::inserter(expected, expected.end()));
+        } else {
+            first.difference(second);
+            std::set_difference(firstKeys.begin(), firstKeys.end(), secondKeys.begin(), secondKeys.end(),
+                                std::inserter(expected, expected.end()));
+        }
+
+        checkEqual(first, expected);
+        assert(second.getSize() == 0);
+    }
+}
+
+int main() {
+    for (bool shared : {true, false}) {
+        testSetOperations(0, 1000, shared, 1);
+        testSetOperations(1000, 0, shared, 2);
+        testSetOperations(1, 10000, shared, 3);
+        testSetOperations(10000, 3, shared, 4);
+        testSetOperations(3000, 3000, shared, 5);
+        // Суммарный размер выше порога распараллеливания
+        testSetOperations(60000, 40000, shared, 6);
+    }
+
+    testJoinSplit();
+    testLazyDeleted();
+    testStrings();
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+
+// AVLTree.h не должен подключать заголовки отображения файлов
+#ifdef PROT_READ
+#error "AVLTree.h includes POSIX mmap headers"
+#endif
+
+#include "../TreeFile.h"
+
+/**
+ * Запись произвольного содержимого файла
+ */
+void writeFile(const std::string& path, const TreeFileHeader& header, const std::vector<long long int>& keys) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(long long int));
+}
+
+/**
+ * Сохранение и загрузка: то же содержимое, дерево можно менять дальше
+ */
+void testRoundTrip() {
+    AVLTree<long long int> tree;
+    for (long long int i = 0; i < 10000; ++i)
+        tree.insert(i * 7 % 10007);
+
+    assert(saveTree(tree, "TreeFileTests.bin"));
+
+    AVLTree<long long int> loaded;
+    loaded.insert(-5);
+    assert(loadTree(loaded, "TreeFileTests.bin"));
+    assert(loaded.getSize() == tree.getSize());
+    assert(std::equal(loaded.begin(), loaded.end(), tree.begin(), tree.end()));
+    assert(!loaded.exist(-5));
+    assert(*loaded.select(100) == *tree.select(100));
+
+    assert(loaded.insert(10008).second);
+    assert(loaded.remove(0));
+    assert(loaded.getSize() == tree.getSize());
+
+    AVLTree<long long int> empty;
+    assert(saveTree(empty, "TreeFileTests.bin"));
+    assert(loadTree(loaded, "TreeFileTests.bin"));
+    assert(loaded.getSize() == 0 && loaded.begin() == loaded.end());
+}
+
+/**
+ * Повреждённые файлы отклоняются, дерево не меняется
+ */
+void testValidation() {
+    AVLTree<long long int> tree;
+    tree.insert(42);
+
+    std::vector<long long int> keys = {1, 2, 3};
+    TreeFileHeader valid = {TreeFileHeader::Magic, sizeof(long long int), keys.size(), 0};
+
+    writeFile("TreeFileTests.bin", valid, keys);
+    AVLTree<long long int> check;
+    assert(loadTree(check, "TreeFileTests.bin") && check.getSize() == 3);
+
+    TreeFileHeader badMagic = valid;
+    badMagic.magic++;
+    writeFile("TreeFileTests.bin", badMagic, keys);
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    TreeFileHeader badKeySize = valid;
+    badKeySize.keySize = 4;
+    writeFile("TreeFileTests.bin", badKeySize, keys);
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    TreeFileHeader badCount = valid;
+    badCount.count = 4;
+    writeFile("TreeFileTests.bin", badCount, keys);
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    writeFile("TreeFileTests.bin", valid, {1, 3, 2});
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    writeFile("TreeFileTests.bin", valid, {1, 1, 2});
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    // Файл короче заголовка
+    std::ofstream("TreeFileTests.bin", std::ios::binary | std::ios::trunc) << "AVL";
+    assert(!loadTree(tree, "TreeFileTests.bin"));
+
+    assert(!loadTree(tree, "TreeFileTests.missing"));
+
+    assert(tree.getSize() == 1 && tree.exist(42));
+}
+
+int main() {
+    testRoundTrip();
+    testValidation();
+    std::remove("TreeFileTests.bin");
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+#ifndef AVLTREE_TREEFILE_H
+#define AVLTREE_TREEFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Заголовок файла дерева
+ * За заголовком подряд лежат count ключей в порядке возрастания
+ * в машинном представлении (без указателей и разделителей),
+ * поэтому файл читается отображением в память без разбора
+ */
+struct TreeFileHeader {
+    /** Сигнатура "AVLTREE1" */
+    static constexpr uint64_t Magic = 0x31454552544c5641ULL;
+
+    uint64_t magic;    // сигнатура
+    uint64_t keySize;  // размер одного ключа в байтах
+    uint64_t count;    // количество ключей
+    uint64_t reserved; // выравнивание ключей (0)
+};
+
+/**
+ * Файл, отображённый в память только для чтения
+ * Страницы подгружаются ядром по мере чтения, последовательный
+ * доступ заранее подсказывается через madvise
+ */
+class MappedFile {
+public:
+
+    /**
+     * Отображение файла целиком
+     * @param path путь к файлу
+     */
+    explicit MappedFile(const char* path) {
+        data = nullptr;
+        length = 0;
+
+        int descriptor = open(path, O_RDONLY);
+
+        if (descriptor < 0)
+            return;
+
+        struct stat info;
+
+        if (fstat(descriptor, &info) == 0 && info.st_size > 0) {
+            void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(mapped);
+                length = info.st_size;
+            }
+        }
+
+        // Отображение остаётся действительным и после закрытия дескриптора
+        close(descriptor);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Деструктор
+     */
+    ~MappedFile() {
+        if (data != nullptr)
+            munmap(const_cast<char*>(data), length);
+    }
+
+    /**
+     * Удалось ли отобразить файл
+     */
+    bool isOpen() const {
+        return data != nullptr;
+    }
+
+    /**
+     * Начало отображения (выровнено на страницу)
+     */
+    const char* begin() const {
+        return data;
+    }
+
+    /**
+     * Размер файла в байтах
+     */
+    size_t getSize() const {
+        return length;
+    }
+
+private:
+    /** Начало отображения */
+    const char* data;
+    /** Размер отображения */
+    size_t length;
+};
+
+/**
+ * Сохранение дерева в файл: заголовок и массив ключей в порядке возрастания
+ * (подходит любое дерево с итераторами и getSize, например AVLTree)
+ * @param tree дерево
+ * @param path путь к файлу
+ * @return удалось ли записать файл
+ */
+template <class Tree>
+bool saveTree(const Tree& tree, const std::string& path) {
+    using Type = typename Tree::iterator::value_type;
+
+    static_assert(std::is_trivially_copyable<Type>::value, "saved keys must be trivially copyable");
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    TreeFileHeader header = {TreeFileHeader::Magic, sizeof(Type), tree.getSize(), 0};
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto it = tree.begin(); it != tree.end(); ++it)
+        file.write(reinterpret_cast<const char*>(&*it), sizeof(Type));
+
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * Загрузка AVLTree из файла, записанного saveTree, за O(n):
+ * файл отображается в память, и дерево строится прямо
+ * из массива ключей без разбора и без поиска места вставки
+ * @param tree дерево
+ * @param path путь к файлу
+ * @return удалось ли загрузить дерево (при ошибке дерево не меняется)
+ */
+template <class Tree>
+bool loadTree(Tree& tree, const std::string& path) {
+    using Type = typename Tree::iterator::value_type;
+
+    static_assert(std::is_trivially_copyable<Type>::value, "loaded keys must be trivially copyable");
+    static_assert(alignof(Type) <= sizeof(TreeFileHeader), "keys in the file are aligned to the header size");
+
+    MappedFile file(path.c_str());
+
+    if (!file.isOpen() || file.getSize() < sizeof(TreeFileHeader))
+        return false;
+
+    const TreeFileHeader* header = reinterpret_cast<const TreeFileHeader*>(file.begin());
+    size_t capacity = (file.getSize() - sizeof(TreeFileHeader)) / sizeof(Type);
+
+    if (header->magic != TreeFileHeader::Magic || header->keySize != sizeof(Type) || header->count != capacity)
+        return false;
+
+    const Type* first = reinterpret_cast<const Type*>(file.begin() + sizeof(TreeFileHeader));
+    const Type* last = first + header->count;
+
+    // Неупорядоченный массив нарушил бы порядок дерева
+    for (const Type* it = first; it + 1 < last; ++it)
+        if (!tree.compare(it[0], it[1]))
+            return false;
+
+    tree.clear();
+    tree.allocator.reserve(header->count);
+    tree.head = tree.buildBalanced(first, last, header->count, nullptr);
+    tree.size = header->count;
+    return true;
+}
+
+#endif //AVLTREE_TREEFILE_H
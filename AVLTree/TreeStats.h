@@ -0,0 +1,90 @@
+#ifndef AVLTREE_TREESTATS_H
+#define AVLTREE_TREESTATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Снимок счётчиков дерева для выгрузки во внешнюю систему мониторинга
+ */
+struct TreeCounters {
+    /** Количество корзин гистограммы глубин (глубина AVL дерева меньше 93) */
+    static constexpr size_t Depths = 96;
+
+    uint64_t singleRotations;         // малые повороты при балансировке
+    uint64_t doubleRotations;         // большие (двойные) повороты
+    uint64_t comparisons;             // вызовы компаратора
+    uint64_t operations;              // операции поиска, вставки и удаления
+    uint64_t maxDepth;                // наибольшая глубина, до которой доходил спуск
+    uint64_t nodes;                   // количество ключей в дереве
+    uint64_t depthHistogram[Depths];  // количество спусков каждой глубины
+};
+
+/**
+ * Политика статистики по умолчанию: ничего не считает,
+ * все вызовы пустые и удаляются компилятором
+ */
+struct NoTreeStats {
+    void singleRotation() {}
+    void doubleRotation() {}
+    void comparison() {}
+    void operation(size_t) {}
+    void depth(size_t) {}
+    void reset() {}
+
+    TreeCounters counters() const {
+        return TreeCounters();
+    }
+};
+
+/**
+ * Политика статистики со счётчиками
+ * Счётчики не атомарны: дерево с этой политикой нельзя читать
+ * из нескольких потоков одновременно
+ */
+class TreeStats {
+public:
+    TreeStats() {
+        reset();
+    }
+
+    void singleRotation() {
+        data.singleRotations++;
+    }
+
+    void doubleRotation() {
+        data.doubleRotations++;
+    }
+
+    void comparison() {
+        data.comparisons++;
+    }
+
+    void operation(size_t count) {
+        data.operations += count;
+    }
+
+    /**
+     * Глубина, на которой закончился спуск (корень - глубина 1)
+     * @param depth глубина
+     */
+    void depth(size_t depth) {
+        if (depth > data.maxDepth)
+            data.maxDepth = depth;
+        data.depthHistogram[depth < TreeCounters::Depths ? depth : TreeCounters::Depths - 1]++;
+    }
+
+    void reset() {
+        data = TreeCounters();
+    }
+
+    TreeCounters counters() const {
+        return data;
+    }
+
+private:
+    /** Счётчики */
+    TreeCounters data;
+};
+
+#endif //AVLTREE_TREESTATS_H
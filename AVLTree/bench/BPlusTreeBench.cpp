@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+#include "../BPlusTreeSet.h"
+#include "Stopwatch.h"
+
+/**
+ * BPlusTreeSet против AVLTree на случайных int64_t: вставка, поиск
+ * (половина искомых ключей есть), полный обход и удаление половины.
+ * Размеры задаются аргументами (по умолчанию 10^6 и 10^7 ключей).
+ * Для 10^8 ключей AVL дереву нужно около 5 ГБ памяти.
+ */
+
+/**
+ * Время этапов одного замера в секундах
+ */
+struct Timings {
+    double insert;
+    double exist;
+    double scan;
+    double remove;
+};
+
+template <class Tree>
+Timings run(const std::vector<int64_t>& keys, const std::vector<int64_t>& queries) {
+    Timings result;
+    Tree tree;
+    Stopwatch watch;
+
+    for (int64_t key : keys)
+        tree.insert(key);
+    result.insert = watch.seconds();
+
+    watch.restart();
+    size_t found = 0;
+    for (int64_t key : queries)
+        found += tree.exist(key);
+    result.exist = watch.seconds();
+
+    watch.restart();
+    int64_t sum = 0;
+    for (int64_t key : tree)
+        sum += key;
+    result.scan = watch.seconds();
+
+    watch.restart();
+    for (size_t i = 0; i < keys.size(); i += 2)
+        tree.remove(keys[i]);
+    result.remove = watch.seconds();
+
+    // Результаты используются, чтобы поиск и обход не были выброшены компилятором
+    if (found > queries.size() || sum == 1)
+        std::printf("%zu %lld\n", found, (long long) sum);
+    return result;
+}
+
+void print(size_t n, const char* name, const Timings& timings) {
+    std::printf("%10zu %12s | %8.3fs %8.3fs %8.3fs %8.3fs\n", n, name,
+                timings.insert, timings.exist, timings.scan, timings.remove);
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {1000000, 10000000};
+
+    if (argc > 1) {
+        sizes.clear();
+        for (int i = 1; i < argc; ++i)
+            sizes.push_back(std::stoul(argv[i]));
+    }
+
+#if defined(__AVX2__)
+    std::printf("node search: AVX2\n");
+#elif defined(__SSE4_2__)
+    std::printf("node search: SSE4.2\n");
+#else
+    std::printf("node search: scalar\n");
+#endif
+    std::printf("%10s %12s | %9s %9s %9s %9s\n", "keys", "tree", "insert", "exist", "scan", "remove");
+
+    for (size_t n : sizes) {
+        std::mt19937_64 random(4);
+        std::vector<int64_t> keys(n);
+        std::vector<int64_t> queries(n);
+
+        for (int64_t& key : keys)
+            key = (int64_t) (random() >> 1);
+        for (size_t i = 0; i < n; ++i)
+            queries[i] = i % 2 == 0 ? keys[random() % n] : (int64_t) (random() >> 1);
+
+        print(n, "BPlusTreeSet", run<BPlusTreeSet<int64_t>>(keys, queries));
+        print(n, "AVLTree", run<AVLTree<int64_t>>(keys, queries));
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+#include "Stopwatch.h"
+
+/**
+ * AVL против WAVL балансировки на нагрузке с преобладанием удалений:
+ * вставка n случайных ключей, удаление половины из них, затем 3n
+ * операций удаление:вставка 2:1 по случайным ключам. Повороты считаются
+ * с TreeStats, время замеряется отдельным проходом без статистики.
+ * Размер задаётся аргументом (по умолчанию 10^6 ключей).
+ */
+
+/**
+ * Операция нагрузки
+ */
+struct Operation {
+    bool insert;
+    long long key;
+};
+
+/**
+ * Результат этапа: повороты и время
+ */
+struct Phase {
+    unsigned long long rotations;
+    double seconds;
+};
+
+template <class Tree>
+void apply(Tree& tree, const std::vector<Operation>& operations) {
+    for (const Operation& operation : operations) {
+        if (operation.insert)
+            tree.insert(operation.key);
+        else
+            tree.remove(operation.key);
+    }
+}
+
+/**
+ * Прогон всех этапов нагрузки
+ * @return повороты и время каждого этапа
+ */
+template <class Balance>
+std::vector<Phase> run(const std::vector<std::vector<Operation>>& phases) {
+    using CountedTree = AVLTree<long long, std::less<long long>, NodePool<Node<long long>>, TreeStats, Balance>;
+    using Tree = AVLTree<long long, std::less<long long>, NodePool<Node<long long>>, NoTreeStats, Balance>;
+
+    std::vector<Phase> result;
+    CountedTree counted;
+    Tree tree;
+
+    for (const std::vector<Operation>& operations : phases) {
+        TreeCounters before = counted.getStats();
+
+        apply(counted, operations);
+
+        TreeCounters after = counted.getStats();
+        Stopwatch watch;
+
+        apply(tree, operations);
+        result.push_back(Phase{after.singleRotations + after.doubleRotations -
+                               before.singleRotations - before.doubleRotations, watch.seconds()});
+    }
+
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::mt19937_64 random(5);
+    std::vector<std::vector<Operation>> phases(3);
+    std::vector<long long> inserted(n);
+    const long long range = 2 * (long long) n;
+
+    for (long long& key : inserted) {
+        key = (long long) (random() % range);
+        phases[0].push_back(Operation{true, key});
+    }
+    for (size_t i = 0; i < n / 2; ++i)
+        phases[1].push_back(Operation{false, inserted[random() % n]});
+    for (size_t i = 0; i < 3 * n; ++i)
+        phases[2].push_back(Operation{random() % 3 == 0, (long long) (random() % range)});
+
+    const char* names[] = {"insert n", "remove n/2", "mixed 3n (2:1)"};
+    std::vector<Phase> avl = run<AVLBalance>(phases);
+    std::vector<Phase> wavl = run<WAVLBalance>(phases);
+
+    std::printf("keys: %zu\n", n);
+    std::printf("%16s | %10s %8s | %10s %8s\n", "phase", "AVL rot", "time", "WAVL rot", "time");
+    for (size_t i = 0; i < phases.size(); ++i) {
+        std::printf("%16s | %10llu %7.3fs | %10llu %7.3fs\n", names[i],
+                    avl[i].rotations, avl[i].seconds, wavl[i].rotations, wavl[i].seconds);
+    }
+
+    return 0;
+}
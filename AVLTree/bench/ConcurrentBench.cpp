@@ -0,0 +1,172 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "../ConcurrentAVLTree.h"
+
+/**
+ * Пропускная способность чтения и записи ConcurrentAVLTree
+ * в сравнении с тем же деревом, где запись идёт под одним мьютексом
+ * (читатели без блокировок, писатели по одному), и с std::set
+ * под std::shared_mutex.
+ * Читатели проверяют случайные ключи, писатели вставляют и удаляют
+ * нечётные ключи, чётные ключи лежат в дереве всё время.
+ */
+
+/** Количество ключей в диапазоне */
+const int KeyRange = 1 << 20;
+/** Длительность одного замера */
+const std::chrono::milliseconds Duration(500);
+
+/**
+ * std::set, защищённый блокировкой читателей-писателей
+ */
+class LockedSet {
+public:
+    bool insert(int key) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return keys.insert(key).second;
+    }
+
+    bool remove(int key) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return keys.erase(key) > 0;
+    }
+
+    bool exist(int key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return keys.count(key) > 0;
+    }
+
+private:
+    mutable std::shared_mutex mutex;
+    std::set<int> keys;
+};
+
+/**
+ * ConcurrentAVLTree, писатели которого сериализуются одним мьютексом
+ */
+class SerializedWriters {
+public:
+    bool insert(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.insert(key);
+    }
+
+    bool remove(int key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return tree.remove(key);
+    }
+
+    bool exist(int key) const {
+        return tree.exist(key);
+    }
+
+private:
+    std::mutex mutex;
+    ConcurrentAVLTree<int> tree;
+};
+
+/**
+ * Результат замера в миллионах операций в секунду
+ */
+struct Throughput {
+    double reads;
+    double writes;
+};
+
+/**
+ * Замер: readers читающих и writers пишущих потоков работают Duration
+ * @param tree заполненное чётными ключами дерево
+ * @return пропускная способность чтения и записи
+ */
+template <class Tree>
+Throughput measure(Tree& tree, int readers, int writers) {
+    std::atomic<bool> stop(false);
+    std::atomic<long> reads(0);
+    std::atomic<long> writes(0);
+    std::atomic<long> found(0);
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&tree, &stop, &reads, &found, r]() {
+            std::mt19937 random(r);
+            long count = 0;
+            long hits = 0;
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                hits += tree.exist((int) (random() % KeyRange));
+                count++;
+            }
+            reads += count;
+            found += hits;
+        });
+    }
+
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&tree, &stop, &writes, w]() {
+            std::mt19937 random(100 + w);
+            long count = 0;
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                int key = (int) (random() % (KeyRange / 2)) * 2 + 1;
+
+                if (random() % 2 == 0)
+                    tree.insert(key);
+                else
+                    tree.remove(key);
+                count++;
+            }
+            writes += count;
+        });
+    }
+
+    std::this_thread::sleep_for(Duration);
+    stop = true;
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Результат поиска используется, чтобы чтения не были выброшены компилятором
+    if (found.load() < 0)
+        std::printf("%ld\n", found.load());
+
+    double seconds = std::chrono::duration<double>(Duration).count();
+    return Throughput{reads / seconds / 1e6, writes / seconds / 1e6};
+}
+
+template <class Tree>
+Throughput run(int readers, int writers) {
+    Tree tree;
+
+    for (int key = 0; key < KeyRange; key += 2)
+        tree.insert(key);
+
+    return measure(tree, readers, writers);
+}
+
+int main() {
+    // Только чтение, только запись и смешанные нагрузки
+    const int configs[][2] = {{1, 0}, {4, 0}, {0, 1}, {0, 2}, {0, 4}, {1, 1}, {4, 1}, {4, 2}, {4, 4}, {8, 4}};
+
+    std::printf("hardware threads: %u, keys: %d\n", std::thread::hardware_concurrency(), KeyRange / 2);
+    std::printf("%8s %8s | %22s | %22s | %22s\n", "readers", "writers",
+                "ConcurrentAVLTree", "one writer mutex", "set + shared_mutex");
+    std::printf("%8s %8s | %10s %11s | %10s %11s | %10s %11s\n", "", "",
+                "read Mop/s", "write Mop/s", "read Mop/s", "write Mop/s", "read Mop/s", "write Mop/s");
+
+    for (const auto& config : configs) {
+        Throughput tree = run<ConcurrentAVLTree<int>>(config[0], config[1]);
+        Throughput serialized = run<SerializedWriters>(config[0], config[1]);
+        Throughput locked = run<LockedSet>(config[0], config[1]);
+
+        std::printf("%8d %8d | %10.2f %11.2f | %10.2f %11.2f | %10.2f %11.2f\n", config[0], config[1],
+                    tree.reads, tree.writes, serialized.reads, serialized.writes, locked.reads, locked.writes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+#include "Stopwatch.h"
+
+/**
+ * Время поиска в дереве (спуск по указателям) и в снимке freeze()
+ * (массив в порядке Эйтцингера). Дерево строится вставками в случайном
+ * порядке, ищутся случайные ключи, половина которых есть в дереве.
+ * Размер задаётся аргументом (по умолчанию 10^4, 10^5 и 10^6 ключей).
+ */
+
+/** Количество поисков в одном замере */
+const size_t Queries = 2000000;
+
+/**
+ * Среднее время одного поиска
+ * @param queries искомые ключи
+ * @param lookup поиск, возвращающий признак найденного ключа
+ * @return наносекунды на поиск
+ */
+template <class Lookup>
+double measure(const std::vector<long long>& queries, Lookup lookup) {
+    Stopwatch watch;
+    size_t found = 0;
+
+    for (long long key : queries)
+        found += lookup(key);
+
+    double nanoseconds = watch.seconds() * 1e9 / queries.size();
+
+    // Результат используется, чтобы поиски не были выброшены компилятором
+    if (found > queries.size())
+        std::printf("%zu\n", found);
+    return nanoseconds;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {10000, 100000, 1000000};
+
+    if (argc > 1)
+        sizes = {std::stoul(argv[1])};
+
+    std::printf("%10s | %12s %12s | %12s %12s\n", "keys", "tree exist", "tree lower", "frozen exist", "frozen lower");
+
+    for (size_t n : sizes) {
+        std::mt19937_64 random(2);
+        std::vector<long long> keys(n);
+        std::vector<long long> queries(Queries);
+
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = 2 * (long long) i;
+        std::shuffle(keys.begin(), keys.end(), random);
+        for (long long& key : queries)
+            key = (long long) (random() % (2 * n));
+
+        AVLTree<long long> tree;
+
+        for (long long key : keys)
+            tree.insert(key);
+
+        FrozenAVLTree<long long> frozen = tree.freeze();
+
+        double treeExist = measure(queries, [&tree](long long key) {
+            return tree.exist(key);
+        });
+        double treeLower = measure(queries, [&tree](long long key) {
+            return tree.lower_bound(key) != tree.end();
+        });
+        double frozenExist = measure(queries, [&frozen](long long key) {
+            return frozen.exist(key);
+        });
+        double frozenLower = measure(queries, [&frozen](long long key) {
+            return frozen.lower_bound(key) != frozen.end();
+        });
+
+        std::printf("%10zu | %10.1fns %10.1fns | %10.1fns %10.1fns\n", n,
+                    treeExist, treeLower, frozenExist, frozenLower);
+    }
+
+    return 0;
+}
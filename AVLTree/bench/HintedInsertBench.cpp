@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../AVLTree.h"
+#include "Stopwatch.h"
+
+/**
+ * Вставка почти упорядоченного потока ключей: обычная insert(key),
+ * insert(end(), key) и insertNearFinger(key). Потоки: возрастающий
+ * и возрастающий с разбросом (каждый ключ смещён от своего места
+ * не более чем на 64 позиции). Ключи - long long и строки с общим
+ * префиксом (сравнение дороже). Время замеряется на дереве без
+ * статистики, сравнения считаются отдельным проходом с TreeStats.
+ * Размер задаётся аргументом (по умолчанию 10^6 ключей).
+ */
+
+/**
+ * Способ вставки
+ */
+enum class Mode {
+    Plain,
+    EndHint,
+    Finger
+};
+
+template <class Tree, class Type>
+void insertAll(Tree& tree, const std::vector<Type>& keys, Mode mode) {
+    for (const Type& key : keys) {
+        switch (mode) {
+            case Mode::Plain:
+                tree.insert(key);
+                break;
+            case Mode::EndHint:
+                tree.insert(tree.end(), key);
+                break;
+            case Mode::Finger:
+                tree.insertNearFinger(key);
+        }
+    }
+}
+
+/**
+ * Время вставки всего потока
+ * @return секунды
+ */
+template <class Type>
+double measureTime(const std::vector<Type>& keys, Mode mode) {
+    AVLTree<Type> tree;
+    Stopwatch watch;
+
+    insertAll(tree, keys, mode);
+    return watch.seconds();
+}
+
+/**
+ * Среднее количество сравнений на вставку
+ */
+template <class Type>
+double measureComparisons(const std::vector<Type>& keys, Mode mode) {
+    AVLTree<Type, std::less<Type>, NodePool<Node<Type>>, TreeStats> tree;
+
+    insertAll(tree, keys, mode);
+    return (double) tree.getStats().comparisons / keys.size();
+}
+
+template <class Type>
+void run(const char* name, const std::vector<Type>& keys) {
+    const Mode modes[] = {Mode::Plain, Mode::EndHint, Mode::Finger};
+    const char* names[] = {"insert(key)", "insert(end, key)", "insertNearFinger"};
+
+    for (size_t i = 0; i < 3; ++i) {
+        std::printf("%18s %18s | %8.3fs %10.1f\n", name, names[i],
+                    measureTime(keys, modes[i]), measureComparisons(keys, modes[i]));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::mt19937_64 random(3);
+    std::vector<long long> monotonic(n);
+    std::vector<long long> jittered(n);
+    std::vector<std::pair<size_t, long long>> arrivals(n);
+
+    // Ключ i приходит в момент i + задержка из [0, 64): ключи
+    // перемешиваются только в пределах 64 позиций
+    for (size_t i = 0; i < n; ++i) {
+        monotonic[i] = (long long) i;
+        arrivals[i] = std::make_pair(i + random() % 64, (long long) i);
+    }
+    std::sort(arrivals.begin(), arrivals.end());
+    for (size_t i = 0; i < n; ++i)
+        jittered[i] = arrivals[i].second;
+
+    std::printf("keys: %zu\n", n);
+    std::vector<std::string> monotonicText(n);
+    std::vector<std::string> jitteredText(n);
+    char buffer[32];
+
+    for (size_t i = 0; i < n; ++i) {
+        std::snprintf(buffer, sizeof(buffer), "event-%020lld", monotonic[i]);
+        monotonicText[i] = buffer;
+        std::snprintf(buffer, sizeof(buffer), "event-%020lld", jittered[i]);
+        jitteredText[i] = buffer;
+    }
+
+    std::printf("%18s %18s | %9s %10s\n", "stream", "insertion", "time", "compares");
+    run("monotonic", monotonic);
+    run("jittered", jittered);
+    run("monotonic string", monotonicText);
+    run("jittered string", jitteredText);
+
+    return 0;
+}
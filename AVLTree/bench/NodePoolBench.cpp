@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../AVLTree.h"
+#include "Stopwatch.h"
+
+/**
+ * Пул узлов (NodePool, по умолчанию) против отдельного new/delete
+ * на каждый узел (NodeAllocator): вставка случайных ключей, удаление
+ * половины, повторная вставка в освободившиеся узлы и разрушение дерева.
+ * Размер задаётся аргументом (по умолчанию 10^5 и 10^6 ключей).
+ */
+
+/**
+ * Время этапов одного замера в секундах
+ */
+struct Timings {
+    double insert;
+    double remove;
+    double reinsert;
+    double teardown;
+};
+
+template <class Allocator>
+Timings run(const std::vector<long long>& keys) {
+    using Tree = AVLTree<long long, std::less<long long>, Allocator>;
+
+    Timings result;
+    Tree* tree = new Tree();
+    Stopwatch watch;
+
+    for (long long key : keys)
+        tree->insert(key);
+    result.insert = watch.seconds();
+
+    watch.restart();
+    for (size_t i = 0; i < keys.size(); i += 2)
+        tree->remove(keys[i]);
+    result.remove = watch.seconds();
+
+    watch.restart();
+    for (size_t i = 0; i < keys.size(); i += 2)
+        tree->insert(keys[i]);
+    result.reinsert = watch.seconds();
+
+    watch.restart();
+    delete tree;
+    result.teardown = watch.seconds();
+
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = {100000, 1000000};
+
+    if (argc > 1)
+        sizes = {std::stoul(argv[1])};
+
+    std::printf("%10s %10s | %8s %8s %8s %9s\n", "keys", "allocator", "insert", "remove", "reinsert", "teardown");
+
+    for (size_t n : sizes) {
+        std::mt19937_64 random(1);
+        std::vector<long long> keys(n);
+
+        for (long long& key : keys)
+            key = (long long) random();
+
+        Timings pool = run<NodePool<Node<long long>>>(keys);
+        Timings single = run<NodeAllocator<Node<long long>>>(keys);
+
+        std::printf("%10zu %10s | %7.3fs %7.3fs %7.3fs %8.4fs\n", n, "NodePool",
+                    pool.insert, pool.remove, pool.reinsert, pool.teardown);
+        std::printf("%10zu %10s | %7.3fs %7.3fs %7.3fs %8.4fs\n", n, "new/delete",
+                    single.insert, single.remove, single.reinsert, single.teardown);
+    }
+
+    return 0;
+}
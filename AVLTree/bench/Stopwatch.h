@@ -0,0 +1,37 @@
+#ifndef AVLTREE_BENCH_STOPWATCH_H
+#define AVLTREE_BENCH_STOPWATCH_H
+
+#include <chrono>
+
+/**
+ * Секундомер для замеров (монотонные часы)
+ */
+class Stopwatch {
+public:
+
+    /**
+     * Конструктор (отсчёт начинается сразу)
+     */
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * Время с начала отсчёта
+     * @return секунды
+     */
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Начать отсчёт заново
+     */
+    void restart() {
+        start = std::chrono::steady_clock::now();
+    }
+
+private:
+    /** Момент начала отсчёта */
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif //AVLTREE_BENCH_STOPWATCH_H
@@ -1,60 +1,174 @@
 #ifndef FIBONACCIHEAP_FIBONACCIHEAP_H
 #define FIBONACCIHEAP_FIBONACCIHEAP_H
 
+#include <cstddef>
 #include <functional>
-#include <cmath>
-
-/**
- * Узел кучи
- * @tparam Type - тип хранимого ключа
- */
-template <typename Type>
-struct Node {
-    /** Хранимый ключ */
-    Type key;
-    /** Указатель на родительский узел */
-    Node* parent;
-    /** Указатель на один из дочерних узлов */
-    Node* child;
-    /** Указатель на левый узел того же предка */
-    Node* left;
-    /** Указатель на правый узел того же предка */
-    Node* right;
-    /** Степень вершины */
-    size_t degree;
-    /** Был ли удален ребенок в процессе изменения ключа этой вершины */
-    bool mark;
-};
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "HeapNode.h"
+#include "NodeSlab.h"
 
 /**
  * Контейнер "куча Фибоначи"
- * @tparam Type - тип хранимых ключей
+ * Узлами можно управлять самостоятельно (insert/extractMin с указателями
+ * на свои узлы) или отдать их куче (push/pop с дескрипторами): тогда
+ * узлы берутся из внутреннего пула и переиспользуются. В одной куче
+ * эти два режима не смешиваются.
+ * Узел может хранить данные рядом с ключом (Payload): тогда куча сравнивает
+ * и изменяет только ключ-приоритет, а decreaseKey записывает лишь новый ключ.
+ * @tparam Type - тип хранимых ключей (приоритетов)
  * @tparam Compare - компаратор для упорядочивания элементов
+ * @tparam Payload - тип данных узла (void - без данных)
  */
-template <class Type, class Compare = std::less<Type>>
+template <class Type, class Compare = std::less<Type>, class Payload = void>
 class FibonacciHeap {
 public:
 
+    /**
+     * Дескриптор элемента, вставленного через push
+     * (действителен, пока элемент не извлечён или не удалён)
+     */
+    class Handle {
+    public:
+        Handle() : node(nullptr) {}
+
+        const Type& operator*() const {
+            return node->key;
+        }
+
+        const Type* operator->() const {
+            return &node->key;
+        }
+
+        /**
+         * Данные элемента (только при Payload, отличном от void)
+         */
+        template <class Value = Payload>
+        Value& value() const {
+            return node->value;
+        }
+
+        bool operator==(const Handle& rhs) const {
+            return node == rhs.node;
+        }
+
+        bool operator!=(const Handle& rhs) const {
+            return node != rhs.node;
+        }
+
+    private:
+        friend class FibonacciHeap;
+
+        /** Узел элемента */
+        Node<Type, Payload>* node;
+
+        explicit Handle(Node<Type, Payload>* node) : node(node) {}
+    };
+
     /**
      * Констркутор по умолчанию
      */
     FibonacciHeap() {
         head = nullptr;
         size = 0;
+
+        for (size_t i = 0; i < MaxDegree; ++i)
+            degrees[i] = nullptr;
     };
 
+    FibonacciHeap(const FibonacciHeap&) = delete;
+    FibonacciHeap& operator=(const FibonacciHeap&) = delete;
+
+    /**
+     * Деструктор
+     * (память узлов из пула освобождается вместе с пулом, ключи
+     * и данные оставшихся узлов разрушаются, если это требуется)
+     */
+    ~FibonacciHeap() {
+        if (pool.getLive() > 0 && !std::is_trivially_destructible<Node<Type, Payload>>::value)
+            destroyList(head);
+    }
+
+    /**
+     * Вставка ключа в узел из внутреннего пула
+     * @param key - ключ
+     * @return - дескриптор элемента
+     */
+    Handle push(const Type& key) {
+        return pushNode(key);
+    }
+
+    Handle push(Type&& key) {
+        return pushNode(std::move(key));
+    }
+
+    /**
+     * Вставка ключа-приоритета вместе с данными в узел из внутреннего пула
+     * @param key - ключ
+     * @param value - данные узла
+     * @return - дескриптор элемента
+     */
+    template <class Value>
+    Handle push(const Type& key, Value&& value) {
+        return pushNode(key, std::forward<Value>(value));
+    }
+
+    /**
+     * Извлечение приоритетного ключа, вставленного через push
+     * (узел возвращается в пул; куча не должна быть пустой;
+     * данные узла можно прочитать до извлечения через getMin())
+     * @return - ключ
+     */
+    Type pop() {
+        Node<Type, Payload>* node = extractMin();
+        Type key = std::move(node->key);
+
+        destroyNode(node);
+        return key;
+    }
+
+    /**
+     * Увеличение приоритета элемента, вставленного через push
+     * (ключи меньшего приоритета игнорируются)
+     * @param handle - дескриптор элемента
+     * @param key - новое значение ключа
+     */
+    void decreaseKey(Handle handle, const Type& key) {
+        decreaseKey(key, handle.node);
+    }
+
+    /**
+     * Уменьшение приоритета элемента, вставленного через push
+     * (ключи большего приоритета игнорируются)
+     * @param handle - дескриптор элемента
+     * @param key - новое значение ключа
+     */
+    void increaseKey(Handle handle, const Type& key) {
+        increaseKey(key, handle.node);
+    }
+
+    /**
+     * Удаление элемента, вставленного через push, за амортизированное O(Lg(n))
+     * @param handle - дескриптор элемента
+     */
+    void erase(Handle handle) {
+        removeNode(handle.node);
+        destroyNode(handle.node);
+    }
+
     /**
      * Вставка узла в кучу
      * @param node - узел
      */
-    void insert(Node<Type>* node) {
+    void insert(Node<Type, Payload>* node) {
         if(size == 0) {
             head = node;
             head->left = node;
             head->right = node;
         }
         else {
-            Node<Type>* previousRight = head->right; // Запоминаем соседний правый элемент
+            Node<Type, Payload>* previousRight = head->right; // Запоминаем соседний правый элемент
 
             // Меняем указатели для вставки узла
             head->right = node;
@@ -82,7 +196,7 @@ public:
      * Функция для просмотра приоритетного узла
      * @return - указатель на приоритетный узел
      */
-    Node<Type>* getMin() const {
+    Node<Type, Payload>* getMin() const {
         return head;
     }
 
@@ -105,18 +219,21 @@ public:
                 head = heap->head;
         }
 
-        heap = nullptr;
+        // Узлы из пула сливаемой кучи теперь принадлежат этой
+        pool.absorb(heap->pool);
+        heap->head = nullptr;
+        heap->size = 0;
     }
 
     /**
      * Функция для извлечения приоритетного узла
      * @return - указатель на приоритетный узел
      */
-    Node<Type>* extractMin() {
+    Node<Type, Payload>* extractMin() {
         if(head == nullptr)
             return nullptr;
 
-        Node<Type>* previousMin = head; // Запоминаем указатель на текущий минимальный ключ
+        Node<Type, Payload>* previousMin = head; // Запоминаем указатель на текущий минимальный ключ
 
         unionLists(head, head->child, true);
 
@@ -145,70 +262,52 @@ public:
         if(head == nullptr)
             return;
 
-        // Создание вспомогательного массива,
-        // для которого выполняется свойство:
-        // если array[i] = Node, то Node.degree = i
-        double f = 1.61803;
-        auto sizeArray = static_cast<size_t>(ceil(log2(size) / log2(f)));
-        auto array = new Node<Type>*[sizeArray + 3];
+        // Один проход по списку корней: следующий корень запоминается
+        // до связывания, а связываются только уже пройденные корни,
+        // поэтому каждый корень рассматривается ровно один раз
+        Node<Type, Payload>* current = head;
+        Node<Type, Payload>* last = head->left;
+        size_t maxDegree = 0;
+        bool done = false;
 
-        for (int i = 0; i < sizeArray + 3; ++i)
-            array[i] = nullptr;
+        while(!done) {
+            Node<Type, Payload>* next = current->right;
 
-        Node<Type>* current = head;     // Указатель для пробега по списку
-        Node<Type>* current2 = nullptr; // Вспомогательный указатель для проверки обхода всего списка
+            done = current == last;
 
-        bool flag = true;
-        while(flag) {
-            size_t index = current->degree;
+            // В таблице degrees[i] - корень степени i (если есть)
+            while(degrees[current->degree] != nullptr) {
+                Node<Type, Payload>* tmp = degrees[current->degree];
 
-            while(array[index] != nullptr) {
-                Node<Type>* tmp = array[index];
-
-                if(tmp == current) {
-                    break;
-                }
-                else if(compare(tmp->key, current->key)) {
+                degrees[current->degree] = nullptr;
+                if(compare(tmp->key, current->key)) {
                     // Смена указателей местами
                     // чтобы текущий был приоритетней
-                    Node<Type>* pt = current;
+                    Node<Type, Payload>* pt = current;
                     current = tmp;
                     tmp = pt;
                 }
 
                 link(tmp, current);
-                array[index++] = nullptr;
             }
 
-            array[current->degree] = current;
-            current2 = current->right;
-
-            flag = false;
-            while(current2 != current){
-                // Так как в нашем списке не может лежать несколько узлов
-                // с одинаковой степенью, то это служит критерием,
-                // что мы обошли не весь список
-                if(array[current2->degree] != current2) {
-                    flag = true;
-                    current = current2;
-                    break;
-                }
-                current2 = current2->right;
-            }
+            degrees[current->degree] = current;
+            if(current->degree > maxDegree)
+                maxDegree = current->degree;
+
+            current = next;
         }
 
+        // Поиск минимума и очистка таблицы для следующего вызова
         head = nullptr;
 
-        for (long int i = sizeArray + 2; i >= 0; i--) {
-            if(array[i] == nullptr) {
+        for (size_t i = 0; i <= maxDegree; ++i) {
+            if(degrees[i] == nullptr)
                 continue;
-            }
-            else if(head == nullptr) {
-                head = array[i];
-            }
-            else if(!compare(head->key, array[i]->key)){
-                head = array[i];
-            }
+
+            if(head == nullptr || compare(degrees[i]->key, head->key))
+                head = degrees[i];
+            degrees[i] = nullptr;
         }
     }
 
@@ -218,12 +317,12 @@ public:
      * @param key - новое значение ключа
      * @param x - узел
      */
-    void decreaseKey(const Type key, Node<Type>* x) {
+    void decreaseKey(const Type key, Node<Type, Payload>* x) {
         if(size == 0 ||  compare(x->key, key))
             return;
         x->key = key;
 
-        Node<Type>* y = x->parent;
+        Node<Type, Payload>* y = x->parent;
 
         // Вырезания узла X из списка детей его родителя
         // в случае если у него есть родитель и новый
@@ -237,6 +336,54 @@ public:
             head = x;
     }
 
+    /**
+     * Уменьшение приоритета ключа в узле
+     * (Ключи большего приоритета игнорируются)
+     * Дети узла переносятся в список корней, сам узел вырезается
+     * у родителя; минимальный узел извлекается и вставляется заново.
+     * @param key - новое значение ключа
+     * @param x - узел
+     */
+    void increaseKey(const Type key, Node<Type, Payload>* x) {
+        if(size == 0 || compare(key, x->key))
+            return;
+
+        if(x == head) {
+            removeNode(x);
+            x->key = key;
+            insert(x);
+            return;
+        }
+
+        x->key = key;
+
+        Node<Type, Payload>* y = x->parent;
+
+        if(y != nullptr) {
+            cut(x, y);
+            cascadingCut(y);
+        }
+
+        // Дети могли стать приоритетнее узла, но не минимума кучи
+        if(x->child != nullptr) {
+            unionLists(head, x->child, true);
+            x->child = nullptr;
+            x->degree = 0;
+        }
+    }
+
+    /**
+     * Удаление узла из кучи за амортизированное O(Lg(n))
+     * (узел остаётся во владении вызывающего)
+     * @param x - узел
+     */
+    void erase(Node<Type, Payload>* x) {
+        if(size == 0)
+            return;
+
+        removeNode(x);
+    }
+
     /**
      * Getter получения размера кучи
      * @return - размер кучи (колличество элементов)
@@ -246,12 +393,82 @@ public:
     }
 
 private:
+    /**
+     * Наибольшая возможная степень узла с запасом: у корня степени k
+     * в поддереве не меньше F(k + 2) узлов, а F(94) > 2^64
+     */
+    static constexpr size_t MaxDegree = 96;
+
     /** Указатель на приоритетный элемент. */
-    Node<Type>* head;
+    Node<Type, Payload>* head;
     /** Колличество элементов в куче. */
     size_t size;
     /** Компаратор для упорядочивания элемментов. */
     Compare compare;
+    /** Корни по степеням при уплотнении (между вызовами пуста) */
+    Node<Type, Payload>* degrees[MaxDegree];
+    /** Пул узлов для push/pop */
+    NodeSlab<Node<Type, Payload>> pool;
+
+    /**
+     * Создание узла в пуле и вставка его в кучу
+     * @param key - ключ
+     * @return - дескриптор элемента
+     */
+    template <class Key, class... Value>
+    Handle pushNode(Key&& key, Value&&... value) {
+        Node<Type, Payload>* node = pool.allocate();
+
+        new (node) Node<Type, Payload>(std::forward<Key>(key), std::forward<Value>(value)...);
+        insert(node);
+        return Handle(node);
+    }
+
+    /**
+     * Разрушение узла и возврат его памяти в пул
+     * @param node - узел
+     */
+    void destroyNode(Node<Type, Payload>* node) {
+        node->~Node<Type, Payload>();
+        pool.deallocate(node);
+    }
+
+    /**
+     * Разрушение ключей и данных всех узлов циклического списка и их потомков
+     * @param list - один из узлов списка
+     */
+    void destroyList(Node<Type, Payload>* list) {
+        if (list == nullptr)
+            return;
+
+        Node<Type, Payload>* current = list;
+
+        do {
+            Node<Type, Payload>* next = current->right;
+
+            destroyList(current->child);
+            current->~Node<Type, Payload>();
+            current = next;
+        } while (current != list);
+    }
+
+    /**
+     * Удаление произвольного узла: узел вырезается в список корней
+     * и становится минимумом, как если бы его ключ уменьшили
+     * до минус бесконечности, затем извлекается
+     * @param x - узел
+     */
+    void removeNode(Node<Type, Payload>* x) {
+        Node<Type, Payload>* y = x->parent;
+
+        if (y != nullptr) {
+            cut(x, y);
+            cascadingCut(y);
+        }
+
+        head = x;
+        extractMin();
+    }
 
     /**
      * Объединение списков вершин
@@ -260,12 +477,12 @@ private:
      * @param flag - определяет, нужно ли удалять у второго списка
      * указатели на родителей вершин
      */
-    void unionLists(Node<Type>* first, Node<Type>* second, bool flag = false) {
+    void unionLists(Node<Type, Payload>* first, Node<Type, Payload>* second, bool flag = false) {
         if (second == nullptr || first == nullptr)
             return;
 
         if (flag) {
-            Node<Type>* current = second->right; // Указатель для пробегания списка по соседним узлам
+            Node<Type, Payload>* current = second->right; // Указатель для пробегания списка по соседним узлам
 
             while(current != second) {
                 current->parent = nullptr;
@@ -275,10 +492,10 @@ private:
         }
 
         // Запоминаем текущие крайние узлы у списков
-        Node<Type>* head1 = first;        // Голова первого списка
-        Node<Type>* tail1 = first->left;  // Конец первого списка
-        Node<Type>* head2 = second;       // Голова второго списка
-        Node<Type>* tail2 = second->left; // Конец второго списка
+        Node<Type, Payload>* head1 = first;        // Голова первого списка
+        Node<Type, Payload>* tail1 = first->left;  // Конец первого списка
+        Node<Type, Payload>* head2 = second;       // Голова второго списка
+        Node<Type, Payload>* tail2 = second->left; // Конец второго списка
 
         // Меняем указатели местами для слияния
         tail1->right = head2;
@@ -292,7 +509,7 @@ private:
      * @param first
      * @param second
      */
-    void link(Node<Type>* first, Node<Type>* second) {
+    void link(Node<Type, Payload>* first, Node<Type, Payload>* second) {
         // Забываем про узел first в списке
         // к которому он принадлежит
         first->right->left = first->left;
@@ -319,7 +536,7 @@ private:
      * @param x - вырезаемаый узел
      * @param y - родитель узла X
      */
-    void cut(Node<Type>* x, Node<Type>* y) {
+    void cut(Node<Type, Payload>* x, Node<Type, Payload>* y) {
 
         // Забываем у узла Y про ребенка X
         y->child = x->right;
@@ -343,8 +560,8 @@ private:
      * Каскадное вырезание (Рекурсия)
      * @param y - узел
      */
-    void cascadingCut(Node<Type>* y) {
-        Node<Type>* z = y->parent;
+    void cascadingCut(Node<Type, Payload>* y) {
+        Node<Type, Payload>* z = y->parent;
 
         if (z == nullptr) {
             return;
@@ -0,0 +1,62 @@
+#ifndef FIBONACCIHEAP_HEAPNODE_H
+#define FIBONACCIHEAP_HEAPNODE_H
+
+#include <cstddef>
+#include <utility>
+
+/**
+ * Данные узла, не участвующие в сравнении
+ * @tparam Payload - тип данных
+ */
+template <typename Payload>
+struct NodePayload {
+    /** Хранимые данные */
+    Payload value;
+
+    NodePayload() = default;
+
+    template <typename Value>
+    explicit NodePayload(Value&& value) : value(std::forward<Value>(value)) {}
+};
+
+/**
+ * Узел без данных
+ */
+template <>
+struct NodePayload<void> {};
+
+/**
+ * Узел кучи
+ * Куча сравнивает и изменяет только ключ (приоритет),
+ * данные узла (value) лежат рядом и не копируются.
+ * Один и тот же узел подходит для всех куч (FibonacciHeap, PairingHeap,
+ * IndexedDaryHeap), каждая использует только нужные ей поля.
+ * @tparam Type - тип хранимого ключа
+ * @tparam Payload - тип данных узла (void - без данных)
+ */
+template <typename Type, typename Payload = void>
+struct Node : NodePayload<Payload> {
+    /** Хранимый ключ */
+    Type key;
+    /** Указатель на родительский узел */
+    Node* parent;
+    /** Указатель на один из дочерних узлов */
+    Node* child;
+    /** Указатель на левый узел того же предка */
+    Node* left;
+    /** Указатель на правый узел того же предка */
+    Node* right;
+    /** Степень вершины */
+    size_t degree;
+    /** Был ли удален ребенок в процессе изменения ключа этой вершины */
+    bool mark;
+
+    Node() = default;
+
+    template <typename Key, typename... Value>
+    explicit Node(Key&& key, Value&&... value)
+        : NodePayload<Payload>(std::forward<Value>(value)...), key(std::forward<Key>(key)),
+          parent(nullptr), child(nullptr), left(nullptr), right(nullptr), degree(0), mark(false) {}
+};
+
+#endif //FIBONACCIHEAP_HEAPNODE_H
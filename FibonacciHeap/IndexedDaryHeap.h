@@ -0,0 +1,229 @@
+#ifndef FIBONACCIHEAP_INDEXEDDARYHEAP_H
+#define FIBONACCIHEAP_INDEXEDDARYHEAP_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Контейнер "индексированная d-арная куча"
+ * Элементы задаются номерами (id) от 0, данные элемента клиент хранит
+ * у себя по тому же номеру. Куча - плоский массив пар (ключ, номер):
+ * потомки элемента i находятся в D*i + 1 ... D*i + D, поэтому при
+ * просеивании ключи сравниваются без переходов по указателям. Ключ
+ * хранится в куче в единственном экземпляре, позиция элемента в массиве
+ * лежит в отдельном массиве position по номеру элемента, по ней
+ * decreaseKey находит элемент за O(1).
+ * Операции те же, что и у FibonacciHeap (insert, getMin, extractMin,
+ * decreaseKey, merge), но вместо узлов - номера элементов.
+ * @tparam Type - тип хранимых ключей (приоритетов)
+ * @tparam D - количество потомков у элемента
+ * @tparam Compare - компаратор для упорядочивания элементов
+ */
+template <class Type, size_t D = 4, class Compare = std::less<Type>>
+class IndexedDaryHeap {
+    static_assert(D >= 2, "d-ary heap needs at least two children per element");
+
+public:
+    /** Номер, означающий отсутствие элемента */
+    static constexpr size_t None = static_cast<size_t>(-1);
+
+    /**
+     * Конструктор
+     * @param capacity - ожидаемое количество номеров элементов
+     */
+    explicit IndexedDaryHeap(size_t capacity = 0) : position(capacity, None) {
+        items.reserve(capacity);
+    }
+
+    /**
+     * Вставка элемента в кучу за O(log_D(n))
+     * @param id - номер элемента (не должен находиться в куче)
+     * @param key - ключ
+     */
+    void insert(size_t id, const Type& key) {
+        if (id >= position.size())
+            position.resize(id + 1, None);
+
+        items.push_back(Item{key, id});
+        siftUp(items.size() - 1);
+    }
+
+    /**
+     * Находится ли элемент в куче
+     * @param id - номер элемента
+     * @return - результат проверки
+     */
+    bool contains(size_t id) const {
+        return id < position.size() && position[id] != None;
+    }
+
+    /**
+     * Ключ элемента, находящегося в куче
+     * @param id - номер элемента
+     * @return - ключ
+     */
+    const Type& getKey(size_t id) const {
+        return items[position[id]].key;
+    }
+
+    /**
+     * Функция для просмотра приоритетного элемента
+     * @return - номер приоритетного элемента (None для пустой кучи)
+     */
+    size_t getMin() const {
+        return items.empty() ? None : items.front().id;
+    }
+
+    /**
+     * Сливание двух куч за O(n + m)
+     * (номера элементов куч не должны пересекаться)
+     * @param heap - сливаемая куча (становится пустой)
+     */
+    void merge(IndexedDaryHeap* heap) {
+        if (heap == nullptr || heap == this || heap->items.empty())
+            return;
+
+        if (heap->position.size() > position.size())
+            position.resize(heap->position.size(), None);
+
+        size_t first = items.size();
+
+        items.insert(items.end(), heap->items.begin(), heap->items.end());
+        for (size_t i = first; i < items.size(); ++i) {
+            position[items[i].id] = i;
+            heap->position[items[i].id] = None;
+        }
+        heap->items.clear();
+
+        // Построение кучи снизу вверх от последнего элемента, имеющего потомков
+        for (size_t i = (items.size() + D - 2) / D; i-- > 0;)
+            siftDown(i);
+    }
+
+    /**
+     * Функция для извлечения приоритетного элемента за O(D*log_D(n))
+     * @return - номер приоритетного элемента (None для пустой кучи)
+     */
+    size_t extractMin() {
+        if (items.empty())
+            return None;
+
+        size_t previousMin = items.front().id;
+
+        position[previousMin] = None;
+        if (items.size() > 1) {
+            items.front() = std::move(items.back());
+            items.pop_back();
+            siftDown(0);
+        } else {
+            items.pop_back();
+        }
+
+        return previousMin;
+    }
+
+    /**
+     * Увеличние приоритета ключа элемента за O(log_D(n))
+     * (Ключи меньшего приоритета игнорируются)
+     * @param key - новое значение ключа
+     * @param id - номер элемента (находится в куче)
+     */
+    void decreaseKey(const Type key, size_t id) {
+        size_t index = position[id];
+
+        if (compare(items[index].key, key))
+            return;
+
+        items[index].key = key;
+        siftUp(index);
+    }
+
+    /**
+     * Getter получения размера кучи
+     * @return - размер кучи (колличество элементов)
+     */
+    size_t getSize() const {
+        return items.size();
+    }
+
+private:
+    /**
+     * Элемент кучи: ключ и номер элемента
+     */
+    struct Item {
+        Type key;
+        size_t id;
+    };
+
+    /** Элементы кучи */
+    std::vector<Item> items;
+    /** Позиции элементов в items по номеру (None - элемента нет в куче) */
+    std::vector<size_t> position;
+    /** Компаратор для упорядочивания элемментов. */
+    Compare compare;
+
+    /**
+     * Подъём элемента к корню, пока он приоритетнее родителя
+     * (элементы сдвигаются, а не меняются местами)
+     * @param index - позиция элемента
+     */
+    void siftUp(size_t index) {
+        Item item = std::move(items[index]);
+
+        while (index > 0) {
+            size_t parent = (index - 1) / D;
+
+            if (!compare(item.key, items[parent].key))
+                break;
+
+            place(index, std::move(items[parent]));
+            index = parent;
+        }
+
+        place(index, std::move(item));
+    }
+
+    /**
+     * Спуск элемента, пока приоритетнейший из потомков приоритетнее него
+     * @param index - позиция элемента
+     */
+    void siftDown(size_t index) {
+        Item item = std::move(items[index]);
+
+        while (true) {
+            size_t first = D * index + 1;
+
+            if (first >= items.size())
+                break;
+
+            size_t last = first + D < items.size() ? first + D : items.size();
+            size_t best = first;
+
+            for (size_t i = first + 1; i < last; ++i)
+                if (compare(items[i].key, items[best].key))
+                    best = i;
+
+            if (!compare(items[best].key, item.key))
+                break;
+
+            place(index, std::move(items[best]));
+            index = best;
+        }
+
+        place(index, std::move(item));
+    }
+
+    /**
+     * Запись элемента в позицию с обновлением его позиции
+     * @param index - позиция
+     * @param item - элемент
+     */
+    void place(size_t index, Item&& item) {
+        position[item.id] = index;
+        items[index] = std::move(item);
+    }
+};
+
+#endif //FIBONACCIHEAP_INDEXEDDARYHEAP_H
@@ -0,0 +1,140 @@
+#ifndef FIBONACCIHEAP_NODESLAB_H
+#define FIBONACCIHEAP_NODESLAB_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Пул узлов кучи
+ * Память выдаётся из непрерывных блоков по BlockSize узлов,
+ * освобождённые узлы складываются в список свободных и выдаются
+ * повторно, поэтому узлы кучи лежат в памяти плотно.
+ * Пул выдаёт неинициализированную память: конструирование
+ * и разрушение узлов выполняет куча.
+ * @tparam NodeType - тип узла
+ * @tparam BlockSize - количество узлов в одном блоке
+ */
+template <class NodeType, size_t BlockSize = 1024>
+class NodeSlab {
+public:
+
+    /**
+     * Конструктор по умолчанию
+     */
+    NodeSlab() {
+        freeList = nullptr;
+        freeTail = nullptr;
+        used = BlockSize;
+        live = 0;
+    }
+
+    NodeSlab(const NodeSlab&) = delete;
+    NodeSlab& operator=(const NodeSlab&) = delete;
+
+    /**
+     * Выделение памяти под один узел
+     * @return указатель на неинициализированную память
+     */
+    NodeType* allocate() {
+        live++;
+
+        if (freeList != nullptr) {
+            FreeNode* node = freeList;
+            freeList = node->next;
+            if (freeList == nullptr)
+                freeTail = nullptr;
+            return reinterpret_cast<NodeType*>(node);
+        }
+
+        if (used == BlockSize) {
+            blocks.emplace_back(new Slot[BlockSize]);
+            used = 0;
+        }
+
+        return reinterpret_cast<NodeType*>(&blocks.back()[used++]);
+    }
+
+    /**
+     * Возврат узла в пул (узел уже должен быть разрушен)
+     * @param node узел
+     */
+    void deallocate(NodeType* node) {
+        FreeNode* free = reinterpret_cast<FreeNode*>(node);
+
+        free->next = freeList;
+        freeList = free;
+        if (freeTail == nullptr)
+            freeTail = free;
+        live--;
+    }
+
+    /**
+     * Передача всех блоков другого пула этому
+     * (узлы другого пула остаются на месте и освобождаются в этот пул)
+     * @param other пул (становится пустым)
+     */
+    void absorb(NodeSlab& other) {
+        if (&other == this)
+            return;
+
+        if (blocks.empty()) {
+            blocks.swap(other.blocks);
+            used = other.used;
+        } else {
+            // Текущим остаётся последний блок этого пула,
+            // свободный хвост текущего блока другого пула не выдаётся
+            blocks.insert(blocks.begin(), std::make_move_iterator(other.blocks.begin()),
+                          std::make_move_iterator(other.blocks.end()));
+        }
+
+        // Список свободных узлов другого пула подвешивается в начало
+        if (other.freeList != nullptr) {
+            other.freeTail->next = freeList;
+            if (freeList == nullptr)
+                freeTail = other.freeTail;
+            freeList = other.freeList;
+        }
+
+        live += other.live;
+        other.blocks.clear();
+        other.freeList = nullptr;
+        other.freeTail = nullptr;
+        other.used = BlockSize;
+        other.live = 0;
+    }
+
+    /**
+     * Количество выданных и ещё не возвращённых узлов
+     */
+    size_t getLive() const {
+        return live;
+    }
+
+private:
+    /** Свободный узел хранит указатель на следующий свободный */
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    /** Память под один узел */
+    union Slot {
+        alignas(NodeType) unsigned char node[sizeof(NodeType)];
+        FreeNode free;
+    };
+
+    /** Блоки памяти */
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    /** Список свободных узлов */
+    FreeNode* freeList;
+    /** Последний свободный узел (для слияния пулов за O(1)) */
+    FreeNode* freeTail;
+    /** Количество занятых узлов в последнем блоке */
+    size_t used;
+    /** Количество выданных узлов */
+    size_t live;
+};
+
+#endif //FIBONACCIHEAP_NODESLAB_H
@@ -0,0 +1,210 @@
+#ifndef FIBONACCIHEAP_PAIRINGHEAP_H
+#define FIBONACCIHEAP_PAIRINGHEAP_H
+
+#include <cstddef>
+#include <functional>
+#include "HeapNode.h"
+
+/**
+ * Контейнер "парная куча"
+ * Тот же интерфейс, что и у FibonacciHeap (insert, getMin, extractMin,
+ * decreaseKey, merge), и тот же узел. Дерево хранится как список детей:
+ * child - первый ребёнок, right - следующий брат, left - предыдущий брат
+ * или родитель (для первого ребёнка). Оценка decreaseKey хуже, чем
+ * у кучи Фибоначчи, но константа намного меньше: нет степеней, пометок
+ * и каскадных вырезаний.
+ * @tparam Type - тип хранимых ключей (приоритетов)
+ * @tparam Compare - компаратор для упорядочивания элементов
+ * @tparam Payload - тип данных узла (void - без данных)
+ */
+template <class Type, class Compare = std::less<Type>, class Payload = void>
+class PairingHeap {
+public:
+
+    /**
+     * Констркутор по умолчанию
+     */
+    PairingHeap() {
+        head = nullptr;
+        size = 0;
+    }
+
+    /**
+     * Вставка узла в кучу за O(1)
+     * @param node - узел
+     */
+    void insert(Node<Type, Payload>* node) {
+        // Очищаем данные узла, он мог находиться в другой куче
+        node->parent = nullptr;
+        node->child = nullptr;
+        node->left = nullptr;
+        node->right = nullptr;
+
+        head = meld(head, node);
+        size++;
+    }
+
+    /**
+     * Функция для просмотра приоритетного узла
+     * @return - указатель на приоритетный узел
+     */
+    Node<Type, Payload>* getMin() const {
+        return head;
+    }
+
+    /**
+     * Сливание двух куч за O(1)
+     * @param heap - сливаемая куча (становится пустой)
+     */
+    void merge(PairingHeap* heap) {
+        if (heap == nullptr || heap == this)
+            return;
+
+        head = meld(head, heap->head);
+        size += heap->size;
+
+        heap->head = nullptr;
+        heap->size = 0;
+    }
+
+    /**
+     * Функция для извлечения приоритетного узла
+     * за амортизированное O(Lg(n))
+     * @return - указатель на приоритетный узел
+     */
+    Node<Type, Payload>* extractMin() {
+        if (head == nullptr)
+            return nullptr;
+
+        Node<Type, Payload>* previousMin = head;
+
+        head = combine(head->child);
+        previousMin->child = nullptr;
+        size--;
+
+        return previousMin;
+    }
+
+    /**
+     * Увеличние приоритета ключа в узле
+     * (Ключи меньшего приоритета игнорируются)
+     * Узел вместе с поддеревом отрезается и сливается с корнем
+     * @param key - новое значение ключа
+     * @param x - узел
+     */
+    void decreaseKey(const Type key, Node<Type, Payload>* x) {
+        if (size == 0 || compare(x->key, key))
+            return;
+        x->key = key;
+
+        if (x == head)
+            return;
+
+        // Вырезание узла из списка детей: left указывает
+        // либо на предыдущего брата, либо на родителя
+        if (x->left->child == x)
+            x->left->child = x->right;
+        else
+            x->left->right = x->right;
+        if (x->right != nullptr)
+            x->right->left = x->left;
+        x->left = nullptr;
+        x->right = nullptr;
+
+        head = meld(head, x);
+    }
+
+    /**
+     * Getter получения размера кучи
+     * @return - размер кучи (колличество элементов)
+     */
+    size_t getSize() const {
+        return size;
+    }
+
+private:
+    /** Указатель на приоритетный элемент. */
+    Node<Type, Payload>* head;
+    /** Колличество элементов в куче. */
+    size_t size;
+    /** Компаратор для упорядочивания элемментов. */
+    Compare compare;
+
+    /**
+     * Слияние двух деревьев: корень с меньшим приоритетом
+     * становится первым ребёнком другого
+     * @param first - корень первого дерева (может быть nullptr)
+     * @param second - корень второго дерева (может быть nullptr)
+     * @return - корень объединённого дерева
+     */
+    Node<Type, Payload>* meld(Node<Type, Payload>* first, Node<Type, Payload>* second) {
+        if (first == nullptr)
+            return second;
+        if (second == nullptr)
+            return first;
+
+        if (compare(second->key, first->key)) {
+            Node<Type, Payload>* tmp = first;
+            first = second;
+            second = tmp;
+        }
+
+        second->left = first;
+        second->right = first->child;
+        if (first->child != nullptr)
+            first->child->left = second;
+        first->child = second;
+
+        return first;
+    }
+
+    /**
+     * Двухпроходное слияние списка братьев после удаления корня
+     * @param list - первый узел списка (может быть nullptr)
+     * @return - корень получившегося дерева
+     */
+    Node<Type, Payload>* combine(Node<Type, Payload>* list) {
+        if (list == nullptr)
+            return nullptr;
+
+        // Первый проход: слева направо попарно, результаты
+        // складываются в стек, связанный через right
+        Node<Type, Payload>* merged = nullptr;
+
+        while (list != nullptr) {
+            Node<Type, Payload>* first = list;
+            Node<Type, Payload>* second = first->right;
+
+            list = second == nullptr ? nullptr : second->right;
+
+            first->left = nullptr;
+            first->right = nullptr;
+            if (second != nullptr) {
+                second->left = nullptr;
+                second->right = nullptr;
+            }
+
+            Node<Type, Payload>* pair = meld(first, second);
+
+            pair->right = merged;
+            merged = pair;
+        }
+
+        // Второй проход: справа налево в одно дерево
+        Node<Type, Payload>* result = merged;
+
+        merged = merged->right;
+        result->right = nullptr;
+        while (merged != nullptr) {
+            Node<Type, Payload>* next = merged->right;
+
+            merged->right = nullptr;
+            result = meld(result, merged);
+            merged = next;
+        }
+
+        return result;
+    }
+};
+
+#endif //FIBONACCIHEAP_PAIRINGHEAP_H
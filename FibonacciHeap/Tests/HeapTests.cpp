@@ -0,0 +1,289 @@
+#undef NDEBUG
+#include <cassert>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../FibonacciHeap.h"
+#include "../PairingHeap.h"
+#include "../IndexedDaryHeap.h"
+
+/**
+ * Данные узла, считающие живые экземпляры
+ */
+struct Counted {
+    static int live;
+
+    Counted() {
+        live++;
+    }
+
+    Counted(const Counted&) {
+        live++;
+    }
+
+    ~Counted() {
+        live--;
+    }
+};
+
+int Counted::live = 0;
+
+/**
+ * Куча с нетривиально разрушаемыми данными разрушает оставшиеся узлы
+ */
+void testPayloadDestroyed() {
+    {
+        FibonacciHeap<long long int, std::less<long long int>, Counted> heap;
+
+        for (long long int i = 0; i < 10; ++i)
+            heap.push(i, Counted());
+        heap.pop();
+        heap.pop();
+        assert(Counted::live == 8);
+    }
+    assert(Counted::live == 0);
+
+    // Для std::string утечку покажет AddressSanitizer
+    FibonacciHeap<long long int, std::less<long long int>, std::string> heap;
+
+    for (long long int i = 0; i < 10; ++i)
+        heap.push(i, std::string(64, 'a' + i));
+}
+
+/**
+ * Приоритет и данные: извлечение по приоритету, данные не меняются
+ */
+void testPayload() {
+    FibonacciHeap<long long int, std::less<long long int>, std::string> heap;
+    auto first = heap.push(5, std::string("five"));
+    heap.push(3, std::string("three"));
+    heap.push(8, std::string("eight"));
+
+    heap.decreaseKey(first, 1);
+    assert(*first == 1);
+    assert(first.value() == "five");
+    assert(heap.getMin()->value == "five");
+    assert(heap.pop() == 1);
+    assert(heap.getMin()->value == "three");
+    assert(heap.pop() == 3);
+    assert(heap.pop() == 8);
+    assert(heap.getSize() == 0);
+}
+
+/**
+ * Случайные push/pop/decreaseKey/increaseKey/erase/merge
+ * сверяются с std::multiset
+ */
+void testRandomOperations() {
+    using Heap = FibonacciHeap<long long int>;
+
+    std::mt19937 random(7);
+    Heap heap;
+    std::multiset<long long int> expected;
+    std::vector<Heap::Handle> handles;
+
+    for (int step = 0; step < 20000; ++step) {
+        int operation = random() % 6;
+
+        if (operation == 0 || handles.empty()) {
+            long long int key = random() % 1000;
+            handles.push_back(heap.push(key));
+            expected.insert(key);
+            continue;
+        }
+
+        size_t index = random() % handles.size();
+        Heap::Handle handle = handles[index];
+        long long int key = *handle;
+
+        if (operation == 1) {
+            long long int smaller = key - random() % 100;
+            heap.decreaseKey(handle, smaller);
+            expected.erase(expected.find(key));
+            expected.insert(smaller);
+        } else if (operation == 2) {
+            long long int larger = key + random() % 100;
+            heap.increaseKey(handle, larger);
+            expected.erase(expected.find(key));
+            expected.insert(larger);
+        } else if (operation == 3) {
+            heap.erase(handle);
+            expected.erase(expected.find(key));
+            handles[index] = handles.back();
+            handles.pop_back();
+        } else if (operation == 4) {
+            // Извлекается минимум, его дескриптор больше не действителен
+            for (size_t i = 0; i < handles.size(); ++i)
+                if (&*handles[i] == &heap.getMin()->key)
+                    index = i;
+            assert(heap.pop() == *expected.begin());
+            expected.erase(expected.begin());
+            handles[index] = handles.back();
+            handles.pop_back();
+        } else {
+            // Слияние с кучей из нескольких новых элементов
+            Heap other;
+            for (int i = 0; i < 3; ++i) {
+                long long int added = random() % 1000;
+                handles.push_back(other.push(added));
+                expected.insert(added);
+            }
+            heap.merge(&other);
+            assert(other.getSize() == 0);
+        }
+
+        assert(heap.getSize() == expected.size());
+        if (!expected.empty())
+            assert(heap.getMin()->key == *expected.begin());
+    }
+
+    while (!expected.empty()) {
+        assert(heap.pop() == *expected.begin());
+        expected.erase(expected.begin());
+    }
+}
+
+/**
+ * Удаление и изменение ключей собственных узлов (insert/extractMin)
+ */
+void testOwnNodes() {
+    Node<int> nodes[8];
+    FibonacciHeap<int> heap;
+
+    for (int i = 0; i < 8; ++i) {
+        nodes[i].key = i * 10;
+        heap.insert(&nodes[i]);
+    }
+
+    assert(heap.extractMin() == &nodes[0]);
+    heap.erase(&nodes[5]);
+    heap.increaseKey(75, &nodes[1]);
+    heap.decreaseKey(5, &nodes[7]);
+
+    int order[] = {7, 2, 3, 4, 6, 1};
+    for (int index : order)
+        assert(heap.extractMin() == &nodes[index]);
+    assert(heap.extractMin() == nullptr);
+}
+
+/**
+ * Парная куча: случайные вставки, уменьшения ключа, извлечения и слияния
+ */
+void testPairingHeap() {
+    std::mt19937 random(11);
+    std::vector<Node<long long int>> nodes(4000);
+    std::vector<size_t> inHeap;
+    std::multiset<long long int> expected;
+    PairingHeap<long long int> heap;
+    size_t used = 0;
+
+    for (int step = 0; step < 12000; ++step) {
+        int operation = random() % 4;
+
+        if ((operation == 0 || inHeap.empty()) && used < nodes.size()) {
+            nodes[used].key = random() % 1000;
+            expected.insert(nodes[used].key);
+            inHeap.push_back(used);
+            heap.insert(&nodes[used++]);
+        } else if (operation == 1 && !inHeap.empty()) {
+            Node<long long int>* node = &nodes[inHeap[random() % inHeap.size()]];
+            long long int smaller = node->key - random() % 100;
+            expected.erase(expected.find(node->key));
+            expected.insert(smaller);
+            heap.decreaseKey(smaller, node);
+        } else if (operation == 2 && !inHeap.empty()) {
+            Node<long long int>* node = heap.extractMin();
+            assert(node->key == *expected.begin());
+            expected.erase(expected.begin());
+            for (size_t& index : inHeap)
+                if (&nodes[index] == node)
+                    index = inHeap.back();
+            inHeap.pop_back();
+        } else if (used + 2 <= nodes.size()) {
+            PairingHeap<long long int> other;
+            for (int i = 0; i < 2; ++i) {
+                nodes[used].key = random() % 1000;
+                expected.insert(nodes[used].key);
+                inHeap.push_back(used);
+                other.insert(&nodes[used++]);
+            }
+            heap.merge(&other);
+            assert(other.getSize() == 0 && other.getMin() == nullptr);
+        }
+
+        assert(heap.getSize() == expected.size());
+        if (!expected.empty())
+            assert(heap.getMin()->key == *expected.begin());
+    }
+}
+
+/**
+ * Индексированная d-арная куча: номера элементов, ключи и слияние
+ */
+template <size_t D>
+void testIndexedDaryHeap() {
+    using Heap = IndexedDaryHeap<long long int, D>;
+
+    std::mt19937 random(13);
+    std::vector<long long int> keys(3000);
+    std::multiset<long long int> expected;
+    Heap heap;
+    size_t next = 0;
+
+    assert(heap.getMin() == Heap::None && heap.extractMin() == Heap::None);
+
+    for (int step = 0; step < 10000; ++step) {
+        int operation = random() % 4;
+
+        if ((operation == 0 || heap.getSize() == 0) && next < keys.size()) {
+            keys[next] = random() % 1000;
+            expected.insert(keys[next]);
+            heap.insert(next, keys[next]);
+            next++;
+        } else if (operation == 1 && next > 0) {
+            size_t id = random() % next;
+            if (!heap.contains(id))
+                continue;
+            long long int smaller = keys[id] - random() % 100;
+            expected.erase(expected.find(keys[id]));
+            expected.insert(smaller);
+            keys[id] = smaller;
+            heap.decreaseKey(smaller, id);
+            assert(heap.getKey(id) == smaller);
+        } else if (operation == 2 && heap.getSize() > 0) {
+            size_t id = heap.extractMin();
+            assert(keys[id] == *expected.begin());
+            assert(!heap.contains(id));
+            expected.erase(expected.begin());
+        } else if (next + 5 <= keys.size()) {
+            Heap other;
+            for (int i = 0; i < 5; ++i) {
+                keys[next] = random() % 1000;
+                expected.insert(keys[next]);
+                other.insert(next, keys[next]);
+                next++;
+            }
+            heap.merge(&other);
+            assert(other.getSize() == 0 && !other.contains(next - 1));
+            assert(heap.contains(next - 1));
+        }
+
+        assert(heap.getSize() == expected.size());
+        if (!expected.empty())
+            assert(keys[heap.getMin()] == *expected.begin());
+    }
+}
+
+int main() {
+    testPayloadDestroyed();
+    testPayload();
+    testRandomOperations();
+    testOwnNodes();
+    testPairingHeap();
+    testIndexedDaryHeap<2>();
+    testIndexedDaryHeap<4>();
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+# Запуск решения на одном тесте: Input копируется в pathbgep.in
+# рабочей папки, pathbgep.out сравнивается с Answer без учёта пробелов
+# Параметры: PROGRAM, HEAP, INPUT, ANSWER, WORK
+
+file(MAKE_DIRECTORY ${WORK})
+configure_file(${INPUT} ${WORK}/pathbgep.in COPYONLY)
+
+execute_process(COMMAND ${PROGRAM} ${HEAP} WORKING_DIRECTORY ${WORK} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${PROGRAM} ${HEAP} exited with ${result}")
+endif()
+
+file(READ ${WORK}/pathbgep.out output)
+file(READ ${ANSWER} answer)
+string(REGEX REPLACE "[ \t\r\n]+" " " output "${output}")
+string(REGEX REPLACE "[ \t\r\n]+" " " answer "${answer}")
+string(STRIP "${output}" output)
+string(STRIP "${answer}" answer)
+
+if(NOT output STREQUAL answer)
+    message(FATAL_ERROR "${HEAP}: wrong answer for ${INPUT}")
+endif()
@@ -1,10 +1,20 @@
 #include <iostream>
 #include <fstream>
 #include <queue>
+#include <climits>
+#include <string>
 #include "FibonacciHeap.h"
+#include "PairingHeap.h"
+#include "IndexedDaryHeap.h"
 
 struct Vertex;
 
+/**
+ * Узел кучи для вершины: ключ - расстояние до вершины
+ * (в начале бесконечность), данные - сама вершина
+ */
+using VertexNode = Node<long long int, Vertex>;
+
 /**
  * Ребро графа
  */
@@ -12,9 +22,9 @@ struct Edge {
     /** Вес ребра */
     long long int weight;
     /** Начало ребра */
-    Node<Vertex>* beginVertex;
+    VertexNode* beginVertex;
     /** Конец ребра */
-    Node<Vertex>* finishVertex;
+    VertexNode* finishVertex;
     /** Следующее инцидентное ребро */
     Edge* nextEdge;
 
@@ -26,21 +36,64 @@ struct Edge {
 struct Vertex {
     /** Номер вершины в графе */
     size_t vertexNumber = 0;
-    /** Расстояние до этой вершины до заданной (В начале бесконечность) */
-    long long int distance = LLONG_MAX;
     /** Указатель на начало списка инцидентных ребер */
     Edge* listEdges = nullptr;
+};
 
-    /**
-     * Перезагрузка оператора "<" для возможности
-     * упорядочивания элементов в куче, так как
-     * std::less использует оператор сравнения
-     * при желании можно изменить компаратор
-     * @param rhs
-     * @return
-     */
-    bool operator<(const Vertex& rhs) const {
-        return this->distance < rhs.distance;
+/**
+ * Работа Дейкстры с кучей узлов вершин (FibonacciHeap, PairingHeap):
+ * в куче лежат сами узлы, ключ узла - текущее расстояние
+ * @tparam Heap - тип кучи
+ */
+template <class Heap>
+struct VertexQueue {
+    Heap heap;
+
+    explicit VertexQueue(size_t) {}
+
+    void insert(VertexNode* vertex) {
+        heap.insert(vertex);
+    }
+
+    void decreaseKey(const long long int key, VertexNode* vertex) {
+        heap.decreaseKey(key, vertex);
+    }
+
+    VertexNode* extractMin(VertexNode*) {
+        return heap.extractMin();
+    }
+
+    size_t getSize() const {
+        return heap.getSize();
+    }
+};
+
+/**
+ * Работа Дейкстры с индексированной кучей: элемент кучи - номер вершины,
+ * расстояние хранится и в куче (приоритет), и в узле вершины (результат)
+ * @tparam D - количество потомков у элемента кучи
+ */
+template <size_t D>
+struct VertexQueue<IndexedDaryHeap<long long int, D>> {
+    IndexedDaryHeap<long long int, D> heap;
+
+    explicit VertexQueue(size_t quantityVertex) : heap(quantityVertex + 1) {}
+
+    void insert(VertexNode* vertex) {
+        heap.insert(vertex->value.vertexNumber, vertex->key);
+    }
+
+    void decreaseKey(const long long int key, VertexNode* vertex) {
+        vertex->key = key;
+        heap.decreaseKey(key, vertex->value.vertexNumber);
+    }
+
+    VertexNode* extractMin(VertexNode* vertexes) {
+        return &vertexes[heap.extractMin()];
+    }
+
+    size_t getSize() const {
+        return heap.getSize();
     }
 };
 
@@ -56,11 +109,12 @@ public:
      * @param oriented - ориентированный ли граф
      */
     Graph(const size_t quantityVertex, bool oriented) : quantityVertex(quantityVertex), oriented(oriented) {
-        vertexes = new Node<Vertex> [quantityVertex + 1];
+        vertexes = new VertexNode [quantityVertex + 1];
         quantityEdge = 0;
 
         for (size_t i = 0; i < quantityVertex + 1; ++i) {
-            vertexes[i].key.vertexNumber = i;
+            vertexes[i].key = LLONG_MAX;
+            vertexes[i].value.vertexNumber = i;
         }
     }
 
@@ -79,13 +133,13 @@ public:
         edge->weight = weight;
 
         // Вставка ребра в начало списка ребер
-        if (vertexes[beginVertex].key.listEdges == nullptr) {
+        if (vertexes[beginVertex].value.listEdges == nullptr) {
             edge->nextEdge = nullptr;
-            vertexes[beginVertex].key.listEdges = edge;
+            vertexes[beginVertex].value.listEdges = edge;
         }
         else {
-            edge->nextEdge = vertexes[beginVertex].key.listEdges;
-            vertexes[beginVertex].key.listEdges = edge;
+            edge->nextEdge = vertexes[beginVertex].value.listEdges;
+            vertexes[beginVertex].value.listEdges = edge;
         }
 
         // Если граф неориентированный, то повторная вставка ребра
@@ -96,13 +150,13 @@ public:
             edge2->finishVertex = &vertexes[beginVertex];
             edge2->weight = weight;
 
-            if (vertexes[finishVertex].key.listEdges == nullptr) {
+            if (vertexes[finishVertex].value.listEdges == nullptr) {
                 edge2->nextEdge = nullptr;
-                vertexes[finishVertex].key.listEdges = edge2;
+                vertexes[finishVertex].value.listEdges = edge2;
             }
             else {
-                edge2->nextEdge = vertexes[finishVertex].key.listEdges;
-                vertexes[finishVertex].key.listEdges = edge2;
+                edge2->nextEdge = vertexes[finishVertex].value.listEdges;
+                vertexes[finishVertex].value.listEdges = edge2;
             }
         }
 
@@ -112,12 +166,14 @@ public:
     /**
      * Алгоритм Дейкстры
      * Расстояние от заданной вершины до каждой
+     * @tparam Heap - куча вершин (FibonacciHeap, PairingHeap или IndexedDaryHeap)
      * @param beginVertex - заданная вершина
      * @param output - файл для вывода результата
      */
+    template <class Heap = FibonacciHeap<long long int, std::less<long long int>, Vertex>>
     void Dijkstra(size_t beginVertex, std::ofstream& output) {
-        FibonacciHeap<Vertex> heap;
-        Edge* current = vertexes[beginVertex].key.listEdges;
+        VertexQueue<Heap> heap(quantityVertex);
+        Edge* current = vertexes[beginVertex].value.listEdges;
 
         // Массив который характеризует в каком состоянии
         // находятся вершины
@@ -130,55 +186,40 @@ public:
             mark[j] = 0;
         }
 
-        vertexes[beginVertex].key.distance = 0;
+        vertexes[beginVertex].key = 0;
         mark[beginVertex] = 2;
 
         while(current != nullptr) {
-            if (mark[current->finishVertex->key.vertexNumber] == 1) {
-                if (current->weight < current->finishVertex->key.distance) {
-                    auto tmp = new Vertex;
-
-                    // Запоминаем информацию у прошлого ключа
-                    // чтобы сохранить корректность алгоритма
-                    (*tmp).vertexNumber = current->finishVertex->key.vertexNumber;
-                    (*tmp).distance = current->weight;
-                    (*tmp).listEdges = current->finishVertex->key.listEdges;
-
-                    heap.decreaseKey((*tmp), current->finishVertex);
+            if (mark[current->finishVertex->value.vertexNumber] == 1) {
+                if (current->weight < current->finishVertex->key) {
+                    // Изменяется только расстояние, вершина остаётся на месте
+                    heap.decreaseKey(current->weight, current->finishVertex);
                 }
             }
-            else if (mark[current->finishVertex->key.vertexNumber] == 0) {
-                current->finishVertex->key.distance = current->weight;
+            else if (mark[current->finishVertex->value.vertexNumber] == 0) {
+                current->finishVertex->key = current->weight;
                 heap.insert(current->finishVertex);
-                mark[current->finishVertex->key.vertexNumber] = 1;
+                mark[current->finishVertex->value.vertexNumber] = 1;
             }
 
             current = current->nextEdge;
         }
 
         while(heap.getSize() != 0) {
-            Node<Vertex>* currentNode = heap.extractMin();
+            VertexNode* currentNode = heap.extractMin(vertexes);
 
-            mark[currentNode->key.vertexNumber] = 2;
-            current = currentNode->key.listEdges;
+            mark[currentNode->value.vertexNumber] = 2;
+            current = currentNode->value.listEdges;
 
             while(current != nullptr) {
-                if (mark[current->finishVertex->key.vertexNumber] == 0) {
-                    current->finishVertex->key.distance = currentNode->key.distance + current->weight;
+                if (mark[current->finishVertex->value.vertexNumber] == 0) {
+                    current->finishVertex->key = currentNode->key + current->weight;
                     heap.insert(current->finishVertex);
-                    mark[current->finishVertex->key.vertexNumber] = 1;
+                    mark[current->finishVertex->value.vertexNumber] = 1;
                 }
-                else if (mark[current->finishVertex->key.vertexNumber] == 1) {
-                    if (current->weight < current->finishVertex->key.distance) {
-                        auto tmp = new Vertex;
-
-                        // Запоминаем информацию у прошлого ключа
-                        // чтобы сохранить корректность алгоритма
-                        (*tmp).vertexNumber = current->finishVertex->key.vertexNumber;
-                        (*tmp).distance = current->weight + currentNode->key.distance;
-                        (*tmp).listEdges = current->finishVertex->key.listEdges;
-
-                        heap.decreaseKey(*tmp, current->finishVertex);
+                else if (mark[current->finishVertex->value.vertexNumber] == 1) {
+                    if (current->weight + currentNode->key < current->finishVertex->key) {
+                        heap.decreaseKey(current->weight + currentNode->key, current->finishVertex);
                     }
                 }
 
@@ -188,13 +229,13 @@ public:
 
         // Выводим результат в файл
         for (size_t i = 1; i < quantityVertex + 1; ++i) {
-            output << vertexes[i].key.distance << " ";
+            output << vertexes[i].key << " ";
         }
     }
 
 private:
     /** Массив вершин */
-    Node<Vertex>* vertexes;
+    VertexNode* vertexes;
     /** Колличество вершин */
     size_t quantityVertex;
     /** Коллиечство ребер */
@@ -203,7 +244,12 @@ private:
     bool oriented;
 };
 
-int main() {
+/**
+ * Решение задачи: куча для алгоритма Дейкстры выбирается
+ * первым аргументом (fibonacci - по умолчанию, pairing, dary)
+ */
+int main(int argc, char* argv[]) {
+    std::string heapName = argc > 1 ? argv[1] : "fibonacci";
     size_t n, m, beginVertex, finishVertex;
     long long int weight;
 
@@ -218,7 +264,12 @@ int main() {
     }
 
     std::ofstream output("pathbgep.out");
-    graph.Dijkstra(1, output);
+    if (heapName == "pairing")
+        graph.Dijkstra<PairingHeap<long long int, std::less<long long int>, Vertex>>(1, output);
+    else if (heapName == "dary")
+        graph.Dijkstra<IndexedDaryHeap<long long int, 4>>(1, output);
+    else
+        graph.Dijkstra(1, output);
 
     return 0;
 }
\ No newline at end of file